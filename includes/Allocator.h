@@ -12,6 +12,7 @@
 #define ALLOCATOR_H
 
 #include <cstddef> // size_t
+#include "RegionProvider.h"
 
 class Allocator
 {
@@ -19,9 +20,11 @@ protected:
     std::size_t m_totalSize;
     std::size_t m_used;
     std::size_t m_peak;
+    // Where Init() gets the backing region from
+    RegionProvider* m_regionProvider;
 
 public:
-    Allocator(const std::size_t totalSize) : m_totalSize{totalSize}, m_used{0}, m_peak{0} {}
+    Allocator(const std::size_t totalSize) : m_totalSize{totalSize}, m_used{0}, m_peak{0}, m_regionProvider{RegionProvider::GetDefault()} {}
 
     virtual ~Allocator() { m_totalSize = 0; }
 
@@ -29,13 +32,38 @@ public:
 
     virtual void Free(void *ptr) = 0;
 
+    /// Free for callers that know the allocation size (sized delete, std::allocator). Allocators that can use the
+    /// size instead of a header override it, it must be the size given to Allocate.
+    virtual void FreeSized(void *ptr, const std::size_t size) { Free(ptr); }
+
+    /// Resizes the block at 'ptr', in place when the allocator can, and keeps its content up to the smaller size.
+    /// Returns nullptr and leaves the block untouched when there is not enough memory or when the allocator cannot
+    /// resize blocks (the default). 'alignment' is the one of the original allocation, used if the block moves.
+    virtual void *Reallocate(void *ptr, const std::size_t newSize, const std::size_t alignment = 0);
+
+    /// False for allocators that only release memory all at once (Reset), adapters then ignore deallocations.
+    virtual bool SupportsFree() const { return true; }
+
+    /// Allocates up to 'count' blocks of 'size' bytes into 'out' and returns how many it got, fewer than 'count'
+    /// means the allocator ran out of memory. The default calls Allocate() once per block, allocators override it
+    /// when they can hand out a whole batch at the cost of one.
+    virtual std::size_t AllocateBatch(const std::size_t size, const std::size_t count, void **out, const std::size_t alignment = 0);
+
+    /// Frees 'count' blocks, the default calls Free() once per block.
+    virtual void FreeBatch(void **ptrs, const std::size_t count);
+
     virtual void Init() = 0;
 
+    /// Must be called before Init().
+    void SetRegionProvider(RegionProvider* provider) { m_regionProvider = provider; }
+    RegionProvider* GetRegionProvider() const { return m_regionProvider; }
+
     friend class Benchmark;
     
     std::size_t GetOffset() const { return m_totalSize; }
-    std::size_t GetUsed() const { return m_used; }
-    std::size_t GetPeak() const { return m_peak; }
+    // Virtual so that allocators keeping concurrent statistics can report them
+    virtual std::size_t GetUsed() const { return m_used; }
+    virtual std::size_t GetPeak() const { return m_peak; }
 };
 
 #endif /* ALLOCATOR_H */
@@ -0,0 +1,163 @@
+/**
+ * Compile-time policies for StaticAllocator.
+ *
+ * A storage policy owns the memory and implements the allocation algorithm, a
+ * lock policy decides whether calls are serialized and a statistics policy
+ * whether the bytes in use are counted. Disabled features are empty inline
+ * functions, so they vanish once StaticAllocator is inlined into the caller.
+ */
+#ifndef ALLOCATORPOLICIES_H
+#define ALLOCATORPOLICIES_H
+
+#include "FreeListAllocator.h"
+#include "RegionProvider.h"
+#include <cassert>  // assert
+#include <cstddef>  // size_t
+#include <mutex>
+
+// Lock policies, used through std::lock_guard
+
+struct NoLock {
+    void lock() {}
+    void unlock() {}
+};
+
+typedef std::mutex MutexLock;
+
+// Statistics policies
+
+class NoStats {
+public:
+    void OnAllocate(const std::size_t size) {}
+    void OnFree(const std::size_t size) {}
+    void Reset() {}
+    std::size_t GetUsed() const { return 0; }
+    std::size_t GetPeak() const { return 0; }
+};
+
+class TrackStats {
+private:
+    std::size_t m_used = 0;
+    std::size_t m_peak = 0;
+public:
+    void OnAllocate(const std::size_t size) {
+        m_used += size;
+        m_peak = m_used > m_peak ? m_used : m_peak;
+    }
+    void OnFree(const std::size_t size) { m_used -= size; }
+    void Reset() { m_used = 0; m_peak = 0; }
+    std::size_t GetUsed() const { return m_used; }
+    std::size_t GetPeak() const { return m_peak; }
+};
+
+// Storage policies, the alignment they get is a compile-time constant once inlined
+
+/// Bump allocation over one region, blocks are only released by Reset().
+class LinearStorage {
+private:
+    RegionProvider* m_regionProvider;
+    std::size_t m_totalSize;
+    std::size_t m_start = 0;
+    std::size_t m_current = 0;
+    std::size_t m_end = 0;
+public:
+    LinearStorage(const std::size_t totalSize) : m_regionProvider{RegionProvider::GetDefault()}, m_totalSize{totalSize} {}
+    ~LinearStorage() { m_regionProvider->Free((void*) m_start, m_totalSize); }
+
+    void Init(const std::size_t alignment) {
+        m_regionProvider->Free((void*) m_start, m_totalSize);
+        m_start = (std::size_t) m_regionProvider->Allocate(m_totalSize, alignment);
+        m_end = m_start + m_totalSize;
+        Reset();
+    }
+
+    void* Allocate(const std::size_t size, const std::size_t alignment) {
+        const std::size_t address = (m_current + alignment - 1) & ~(alignment - 1);
+        if (address + size > m_end) {
+            return nullptr;
+        }
+        m_current = address + size;
+        return (void*) address;
+    }
+
+    void Free(void* ptr, const std::size_t size) {}
+
+    void Reset() { m_current = m_start; }
+private:
+    LinearStorage(LinearStorage &linearStorage);
+};
+
+/// Fixed-size chunks of at most ChunkSize bytes on an intrusive free list.
+template <std::size_t ChunkSize>
+class PoolStorage {
+private:
+    struct Node {
+        Node* next;
+    };
+
+    RegionProvider* m_regionProvider;
+    std::size_t m_totalSize;
+    void* m_start_ptr = nullptr;
+    std::size_t m_chunkSize = 0;
+    Node* m_head = nullptr;
+public:
+    static_assert(ChunkSize >= sizeof(Node), "Chunks must be able to hold the free list link");
+
+    PoolStorage(const std::size_t totalSize) : m_regionProvider{RegionProvider::GetDefault()}, m_totalSize{totalSize} {}
+    ~PoolStorage() { m_regionProvider->Free(m_start_ptr, m_totalSize); }
+
+    void Init(const std::size_t alignment) {
+        m_regionProvider->Free(m_start_ptr, m_totalSize);
+        m_start_ptr = m_regionProvider->Allocate(m_totalSize, alignment);
+        // Every chunk keeps the alignment of the first one
+        m_chunkSize = (ChunkSize + alignment - 1) & ~(alignment - 1);
+        Reset();
+    }
+
+    void* Allocate(const std::size_t size, const std::size_t alignment) {
+        assert(size <= ChunkSize && "Allocation size is bigger than the chunk size");
+        Node* chunk = m_head;
+        if (chunk != nullptr) {
+            m_head = chunk->next;
+        }
+        return (void*) chunk;
+    }
+
+    void Free(void* ptr, const std::size_t size) {
+        Node* chunk = (Node*) ptr;
+        chunk->next = m_head;
+        m_head = chunk;
+    }
+
+    void Reset() {
+        m_head = nullptr;
+        const std::size_t nChunks = m_totalSize / m_chunkSize;
+        for (std::size_t i = nChunks; i > 0; --i) {
+            Free((void*) ((std::size_t) m_start_ptr + (i - 1) * m_chunkSize), m_chunkSize);
+        }
+    }
+private:
+    PoolStorage(PoolStorage &poolStorage);
+};
+
+/// FreeListAllocator with its placement policy chosen at compile time.
+template <FreeListAllocator::PlacementPolicy Placement>
+class FreeListStorage {
+private:
+    FreeListAllocator m_allocator;
+public:
+    FreeListStorage(const std::size_t totalSize) : m_allocator(totalSize, Placement) {}
+
+    void Init(const std::size_t alignment) { m_allocator.Init(); }
+
+    // The free list needs 8 byte alignment at least
+    void* Allocate(const std::size_t size, const std::size_t alignment) { return m_allocator.AllocateWith<Placement>(size, alignment < 8 ? 8 : alignment); }
+
+    void Free(void* ptr, const std::size_t size) { m_allocator.FreeWith<Placement>(ptr); }
+
+    void Reset() { m_allocator.Reset(); }
+private:
+    FreeListStorage(FreeListStorage &freeListStorage);
+};
+
+#endif /* ALLOCATORPOLICIES_H */
@@ -0,0 +1,30 @@
+#ifndef ALLOCATORRESOURCE_H
+#define ALLOCATORRESOURCE_H
+
+#include "Allocator.h"
+#include <memory_resource>
+
+/**
+ * @brief std::pmr::memory_resource backed by one of our allocators.
+ *
+ * Lets the std::pmr containers allocate from any Allocator. Deallocations are
+ * forwarded with their size through FreeSized(), and dropped for allocators
+ * that only release memory on Reset(). Allocation failures throw
+ * std::bad_alloc as the standard requires.
+ */
+class AllocatorResource : public std::pmr::memory_resource {
+private:
+    Allocator* m_allocator;
+public:
+    explicit AllocatorResource(Allocator* allocator);
+
+    Allocator* GetAllocator() const { return m_allocator; }
+protected:
+    virtual void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    virtual void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+
+    virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+#endif /* ALLOCATORRESOURCE_H */
@@ -34,12 +34,44 @@ public:
 	void SingleAllocation(std::unique_ptr<Allocator>& allocator, const std::size_t size, const std::size_t alignment);
 	void SingleFree(std::unique_ptr<Allocator>& allocator, const std::size_t size, const std::size_t alignment);
 
+	// Same workloads as SingleAllocation/SingleFree through AllocateBatch/FreeBatch, 'batchSize' blocks per call
+	void BatchAllocation(std::unique_ptr<Allocator>& allocator, const std::size_t size, const std::size_t alignment, const std::size_t batchSize);
+	void BatchFree(std::unique_ptr<Allocator>& allocator, const std::size_t size, const std::size_t alignment, const std::size_t batchSize);
+
+	// A buffer grown by 'step' bytes at a time up to 'maxSize' through Reallocate
+	void Reallocation(std::unique_ptr<Allocator>& allocator, const std::size_t step, const std::size_t maxSize);
+
+	// Allocates 'nObjects' objects of 'size' bytes and frees them newest first through FreeSized, reports the bytes
+	// each object costs at the peak
+	void SmallObjects(std::unique_ptr<Allocator>& allocator, const std::size_t size, const std::size_t nObjects);
+
+	// SingleAllocation/SingleFree through a StaticAllocator, every call is resolved at compile time
+	template <class StaticAllocatorType>
+	void StaticSingleAllocation(StaticAllocatorType& allocator, const std::size_t size);
+	template <class StaticAllocatorType>
+	void StaticSingleFree(StaticAllocatorType& allocator, const std::size_t size);
+
 	void MultipleAllocation(std::unique_ptr<Allocator>& allocator, const std::vector<std::size_t>& allocationSizes, const std::vector<std::size_t>& alignments);
 	void MultipleFree(std::unique_ptr<Allocator>& allocator, const std::vector<std::size_t>& allocationSizes, const std::vector<std::size_t>& alignments);
 
 	void RandomAllocation(std::unique_ptr<Allocator>& allocator, const std::vector<std::size_t>& allocationSizes, const std::vector<std::size_t>& alignments);
 	void RandomFree(std::unique_ptr<Allocator>& allocator, const std::vector<std::size_t>& allocationSizes, const std::vector<std::size_t>& alignments);
 
+	// Keeps m_nOperations blocks alive and replaces random ones, the free blocks end up fragmented
+	void RandomChurn(std::unique_ptr<Allocator>& allocator, const std::vector<std::size_t>& allocationSizes, const std::vector<std::size_t>& alignments);
+
+	// Every thread performs the RandomFree workload at the same time on the shared allocator
+	void MultiThreadedRandomFree(std::unique_ptr<Allocator>& allocator, const std::vector<std::size_t>& allocationSizes, const std::vector<std::size_t>& alignments, const unsigned int nThreads);
+
+	// Allocates on the calling thread and frees every block on a second thread, as in a producer/consumer pipeline
+	void CrossThreadFree(std::unique_ptr<Allocator>& allocator, const std::size_t size, const std::size_t alignment);
+
+	// Standard containers on top of the allocator through std::pmr, a null allocator measures the default resource
+	void VectorGrowth(std::unique_ptr<Allocator>& allocator);
+	void NodeMap(std::unique_ptr<Allocator>& allocator);
+	void Strings(std::unique_ptr<Allocator>& allocator);
+	void Containers(std::unique_ptr<Allocator>& allocator);
+
 private:
 	void PrintResults(const BenchmarkResults& results) const;
 
@@ -70,4 +102,6 @@ private:
     std::chrono::milliseconds TimeElapsed;
 };
 
+#include "BenchmarkImpl.h"
+
 #endif /* BENCHMARK_H */
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "Benchmark.h"
+#include <iostream>
+
+template <class StaticAllocatorType>
+void Benchmark::StaticSingleAllocation(StaticAllocatorType& allocator, const std::size_t size) {
+    std::cout << "BENCHMARK: STATIC ALLOCATION" << IO::endl;
+    std::cout << "\tSize:     \t" << size << IO::endl;
+
+    StartRound();
+
+    allocator.Init();
+
+    auto operations = 0u;
+
+    while (operations < m_nOperations) {
+        allocator.Allocate(size);
+        ++operations;
+    }
+
+    FinishRound();
+
+    BenchmarkResults results = buildResults(m_nOperations, std::move(TimeElapsed), allocator.GetPeak());
+
+    PrintResults(results);
+}
+
+template <class StaticAllocatorType>
+void Benchmark::StaticSingleFree(StaticAllocatorType& allocator, const std::size_t size) {
+    std::cout << "BENCHMARK: STATIC ALLOCATION/FREE" << IO::endl;
+    std::cout << "\tSize:     \t" << size << IO::endl;
+
+    void* addresses[OPERATIONS];
+
+    StartRound();
+
+    allocator.Init();
+
+    auto operations = 0u;
+
+    while (operations < m_nOperations) {
+        addresses[operations] = allocator.Allocate(size);
+        ++operations;
+    }
+
+    while (operations) {
+        allocator.Free(addresses[--operations], size);
+    }
+
+    FinishRound();
+
+    BenchmarkResults results = buildResults(m_nOperations, std::move(TimeElapsed), allocator.GetPeak());
+
+    PrintResults(results);
+}
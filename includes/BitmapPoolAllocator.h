@@ -0,0 +1,81 @@
+#ifndef BITMAPPOOLALLOCATOR_H
+#define BITMAPPOOLALLOCATOR_H
+
+#include "Allocator.h"
+#include <cstdint> // uint64_t
+
+/**
+ * @brief Pool whose chunk occupancy lives in a side bitmap instead of an intrusive free list.
+ *
+ * Free chunks are never written, so Reset() only touches the bitmap and
+ * ReleaseFreePages() can hand whole free pages back to the OS. Allocate()
+ * takes the lowest free chunk, found with ctz on the first non-empty bitmap
+ * word (AVX2 scans four words at a time when the CPU has it), so reuse stays
+ * address ordered and packed at the start of the region. It returns nullptr
+ * when every chunk is taken.
+ */
+class BitmapPoolAllocator : public Allocator {
+private:
+    void* m_start_ptr = nullptr;
+    std::size_t m_chunkSize;
+    std::size_t m_nChunks;
+    // One bit per chunk, set when the chunk is free
+    uint64_t* m_freeMap = nullptr;
+    std::size_t m_nWords;
+    // No word before this one has a free chunk
+    std::size_t m_firstFreeWord;
+    bool m_useAvx2;
+public:
+    BitmapPoolAllocator(const std::size_t totalSize, const std::size_t chunkSize);
+
+    virtual ~BitmapPoolAllocator();
+
+    virtual void* Allocate(const std::size_t size, const std::size_t alignment = 0) override;
+
+    virtual void Free(void* ptr) override;
+
+    /// Takes free chunks a whole bitmap word at a time, returns fewer when the pool is exhausted.
+    virtual std::size_t AllocateBatch(const std::size_t size, const std::size_t count, void** out, const std::size_t alignment = 0) override;
+
+    virtual void Init() override;
+
+    virtual void Reset();
+
+    /// Frees every allocated chunk starting in [ptr, ptr + size), ptr must be the start of a chunk.
+    void FreeRange(void* ptr, const std::size_t size);
+
+    /// Decommits the pages that only hold free chunks, they are zero filled when used again.
+    /// Returns the number of bytes released.
+    std::size_t ReleaseFreePages();
+
+    /// Calls 'visitor' with every allocated chunk in address order.
+    template <class Visitor>
+    void ForEachAllocated(Visitor visitor) const;
+
+    bool IsAllocated(const void* ptr) const;
+
+    void* GetStartPtr() const { return m_start_ptr; }
+private:
+    BitmapPoolAllocator(BitmapPoolAllocator &bitmapPoolAllocator);
+
+    /// Index of the first word at or after 'word' with a free chunk, m_nWords if there is none.
+    std::size_t FindFreeWord(std::size_t word) const;
+
+    void* ChunkAt(const std::size_t chunk) const { return (void*) ((std::size_t) m_start_ptr + chunk * m_chunkSize); }
+    std::size_t ChunkOf(const void* ptr) const { return ((std::size_t) ptr - (std::size_t) m_start_ptr) / m_chunkSize; }
+    /// Mask of the valid chunks in 'word', only the last word is partial.
+    uint64_t WordMask(const std::size_t word) const;
+};
+
+template <class Visitor>
+void BitmapPoolAllocator::ForEachAllocated(Visitor visitor) const {
+    for (std::size_t word = 0; word < m_nWords; ++word) {
+        uint64_t allocated = ~m_freeMap[word] & WordMask(word);
+        while (allocated != 0) {
+            visitor(ChunkAt(word * 64 + __builtin_ctzll(allocated)));
+            allocated &= allocated - 1;
+        }
+    }
+}
+
+#endif /* BITMAPPOOLALLOCATOR_H */
@@ -0,0 +1,71 @@
+#ifndef CONCURRENTPOOLALLOCATOR_H
+#define CONCURRENTPOOLALLOCATOR_H
+
+#include "Allocator.h"
+#include <atomic>
+#include <cstdint> // uint32_t, uint64_t
+
+/**
+ * @brief Pool allocator that can be shared between threads without locks.
+ *
+ * The free chunks form a Treiber stack. Links are 32-bit chunk indices kept in
+ * a side array, and the head packs the top index with a 32-bit generation tag
+ * that changes on every successful update, so a single 64-bit CAS is enough
+ * to rule out ABA. Because links never live in the chunks, a thread racing on
+ * a stale head only ever reads valid indices.
+ *
+ * Allocate returns nullptr when the pool is exhausted.
+ */
+class ConcurrentPoolAllocator : public Allocator {
+private:
+    static const uint32_t EMPTY = 0;
+
+    void* m_start_ptr = nullptr;
+    std::size_t m_chunkSize;
+    std::size_t m_nChunks;
+    // m_next[i] holds the stack entry below chunk i, as an index + 1 (EMPTY is the bottom)
+    std::atomic<uint32_t>* m_next = nullptr;
+
+    std::atomic<uint64_t> m_head;
+    // Keeps the statistics off the cache line of the head
+    char m_padding[64];
+    std::atomic<std::size_t> m_allocatedChunks;
+    std::atomic<std::size_t> m_peakChunks;
+
+public:
+    ConcurrentPoolAllocator(const std::size_t totalSize, const std::size_t chunkSize);
+
+    virtual ~ConcurrentPoolAllocator();
+
+    virtual void* Allocate(const std::size_t size, const std::size_t alignment = 0) override;
+
+    virtual void Free(void* ptr) override;
+
+    virtual void Init() override;
+
+    /// Not thread safe, all chunks must be returned and no other thread may use the pool.
+    virtual void Reset();
+
+    /// Pops up to 'count' chunks with a single CAS and returns how many were stored in 'out'.
+    virtual std::size_t AllocateBatch(const std::size_t size, const std::size_t count, void** out, const std::size_t alignment = 0) override;
+
+    /// Pushes 'count' chunks with a single CAS.
+    virtual void FreeBatch(void** ptrs, const std::size_t count) override;
+
+    virtual std::size_t GetUsed() const override { return m_allocatedChunks.load(std::memory_order_relaxed) * m_chunkSize; }
+    virtual std::size_t GetPeak() const override { return m_peakChunks.load(std::memory_order_relaxed) * m_chunkSize; }
+
+private:
+    ConcurrentPoolAllocator(ConcurrentPoolAllocator &concurrentPoolAllocator);
+
+    void PushChain(const uint32_t first, const uint32_t last);
+    void UpdateStatistics(const std::size_t allocated);
+
+    uint32_t ToIndex(const void* ptr) const { return (uint32_t) (((std::size_t) ptr - (std::size_t) m_start_ptr) / m_chunkSize) + 1; }
+    void* ToChunk(const uint32_t index) const { return (void*) ((std::size_t) m_start_ptr + (index - 1) * m_chunkSize); }
+
+    static uint64_t MakeHead(const uint64_t previousHead, const uint32_t index) { return (((previousHead >> 32) + 1) << 32) | index; }
+    static uint32_t HeadIndex(const uint64_t head) { return (uint32_t) head; }
+};
+
+#endif /* CONCURRENTPOOLALLOCATOR_H */
@@ -0,0 +1,71 @@
+#ifndef DOUBLEENDEDSTACKALLOCATOR_H
+#define DOUBLEENDEDSTACKALLOCATOR_H
+
+#include "Allocator.h"
+
+/**
+ * @brief Two stacks growing towards each other in a single region.
+ *
+ * The bottom stack grows up from the start of the region and the top stack
+ * grows down from its end, so two lifetime classes (e.g. level data and frame
+ * scratch) share the headroom and an allocation only fails when both ends meet.
+ * Each end has its own LIFO Free and markers. Allocate() and Free() from the
+ * Allocator interface use the bottom end, Free() also accepts top pointers.
+ */
+class DoubleEndedStackAllocator : public Allocator {
+public:
+    // Offset of one end, everything allocated past it on that end is released by FreeToMarker()
+    typedef std::size_t Marker;
+
+private:
+    struct AllocationHeader {
+        // Offset of the end before the allocation
+        std::size_t previousOffset;
+    };
+
+    void* m_start_ptr = nullptr;
+    // Free space is [m_bottom, m_top)
+    std::size_t m_bottom;
+    std::size_t m_top;
+
+public:
+    DoubleEndedStackAllocator(const std::size_t totalSize);
+
+    virtual ~DoubleEndedStackAllocator();
+
+    virtual void* Allocate(const std::size_t size, const std::size_t alignment = 0) override;
+
+    virtual void Free(void* ptr) override;
+
+    virtual void Init() override;
+
+    virtual void Reset();
+
+    void* AllocateBottom(const std::size_t size, const std::size_t alignment = 0);
+    void* AllocateTop(const std::size_t size, const std::size_t alignment = 0);
+
+    /// Must be the last allocation of the bottom end.
+    void FreeBottom(void* ptr);
+    /// Must be the last allocation of the top end.
+    void FreeTop(void* ptr);
+
+    Marker GetBottomMarker() const { return m_bottom; }
+    Marker GetTopMarker() const { return m_top; }
+    void FreeToBottomMarker(const Marker marker);
+    void FreeToTopMarker(const Marker marker);
+
+    void ResetBottom() { FreeToBottomMarker(0); }
+    void ResetTop() { FreeToTopMarker(m_totalSize); }
+
+    void* GetStartPtr() const { return m_start_ptr; }
+    std::size_t GetFreeSize() const { return m_top - m_bottom; }
+private:
+    DoubleEndedStackAllocator(DoubleEndedStackAllocator &doubleEndedStackAllocator);
+
+    void UpdateUsed();
+
+    // Headers are read and written in place, so allocations are at least aligned for them
+    static std::size_t EffectiveAlignment(const std::size_t alignment) { return alignment > alignof(AllocationHeader) ? alignment : alignof(AllocationHeader); }
+};
+
+#endif /* DOUBLEENDEDSTACKALLOCATOR_H */
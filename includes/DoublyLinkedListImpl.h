@@ -23,6 +23,7 @@ void DoublyLinkedList<T>::insert(Node* previousNode, Node* newNode) {
             // Is the last node
             previousNode->next = newNode;
             newNode->next = nullptr;
+            newNode->previous = previousNode;
         }else {
             // Is a middle node
             newNode->next = previousNode->next;
@@ -0,0 +1,77 @@
+#ifndef FIXEDPOOL_H
+#define FIXEDPOOL_H
+
+#include <cstddef> // size_t
+#include <cstdint> // uint16_t, uint32_t
+#include <type_traits> // conditional
+
+namespace FixedPoolLayout {
+    /// Largest power of two dividing chunkSize, capped at the fundamental alignment.
+    constexpr std::size_t NaturalAlignment(const std::size_t chunkSize) {
+        std::size_t alignment = 1;
+        while (chunkSize % (alignment * 2) == 0 && alignment * 2 <= alignof(std::max_align_t)) {
+            alignment *= 2;
+        }
+        return alignment;
+    }
+
+    constexpr std::size_t RoundUp(const std::size_t size, const std::size_t alignment) {
+        return (size + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+/**
+ * @brief Pool of Count chunks of ChunkSize bytes kept inside the object itself.
+ *
+ * The layout is fixed at compile time and the constructor is constexpr, so a
+ * global pool is constant-initialized into .bss and nothing runs at startup.
+ * Free chunks are linked by 16-bit indices (32-bit past 65535 chunks) instead
+ * of pointers, so chunks of 2 or 4 bytes can be pooled and the links take less
+ * cache. Chunks that were never used are handed out by a bump index, there is
+ * no Init() threading the whole pool.
+ *
+ *     static FixedPool<4, 1024> g_handles;
+ */
+template <std::size_t ChunkSize, std::size_t Count, std::size_t Align = FixedPoolLayout::NaturalAlignment(ChunkSize)>
+class FixedPool {
+public:
+    typedef typename std::conditional<(Count < UINT16_MAX), uint16_t, uint32_t>::type Index;
+
+    static constexpr Index NONE = (Index) -1;
+    static constexpr std::size_t CHUNK_STRIDE = FixedPoolLayout::RoundUp(ChunkSize > sizeof(Index) ? ChunkSize : sizeof(Index), Align);
+    static constexpr std::size_t CAPACITY = Count;
+    static constexpr std::size_t STORAGE_SIZE = CHUNK_STRIDE * Count;
+
+    static_assert(ChunkSize > 0 && Count > 0, "The pool must hold at least one chunk");
+    static_assert(Align != 0 && (Align & (Align - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Count < UINT32_MAX, "Chunks are indexed with 32 bits at most");
+private:
+    alignas(Align) unsigned char m_storage[STORAGE_SIZE];
+    Index m_head;
+    // Chunks at and past this index have never been allocated
+    Index m_bump;
+    Index m_used;
+public:
+    constexpr FixedPool() : m_storage{}, m_head{NONE}, m_bump{0}, m_used{0} {}
+
+    void* Allocate();
+
+    void Free(void* ptr);
+
+    /// Returns every chunk to the pool in constant time.
+    void Reset();
+
+    bool Owns(const void* ptr) const { return (std::size_t) ptr - (std::size_t) m_storage < STORAGE_SIZE; }
+
+    std::size_t GetUsed() const { return (std::size_t) m_used * ChunkSize; }
+    std::size_t GetFreeCount() const { return Count - m_used; }
+private:
+    FixedPool(FixedPool &fixedPool);
+
+    void* ChunkAt(const Index index) { return m_storage + (std::size_t) index * CHUNK_STRIDE; }
+    Index IndexOf(const void* ptr) const { return (Index) (((std::size_t) ptr - (std::size_t) m_storage) / CHUNK_STRIDE); }
+};
+
+#include "FixedPoolImpl.h"
+
+#endif /* FIXEDPOOL_H */
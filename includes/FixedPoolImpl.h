@@ -0,0 +1,47 @@
+#include "FixedPool.h"
+#include <cassert> /* assert */
+#include <cstring> /* memcpy */
+#ifdef _DEBUG
+#include <iostream>
+#endif
+
+template <std::size_t ChunkSize, std::size_t Count, std::size_t Align>
+void* FixedPool<ChunkSize, Count, Align>::Allocate() {
+    Index index = m_head;
+    if (index != NONE) {
+        // The link may be narrower than the chunk alignment, memcpy keeps the access legal
+        std::memcpy(&m_head, ChunkAt(index), sizeof(Index));
+    } else if (m_bump < Count) {
+        index = m_bump++;
+    } else {
+        return nullptr;
+    }
+    ++m_used;
+
+#ifdef _DEBUG
+    std::cout << "A" << "\t@S " << (void*) m_storage << "\t@R " << ChunkAt(index) << "\tI " << (std::size_t) index << std::endl;
+#endif
+
+    return ChunkAt(index);
+}
+
+template <std::size_t ChunkSize, std::size_t Count, std::size_t Align>
+void FixedPool<ChunkSize, Count, Align>::Free(void* ptr) {
+    assert(Owns(ptr) && "Pointer does not belong to this pool");
+    assert(((std::size_t) ptr - (std::size_t) m_storage) % CHUNK_STRIDE == 0 && "Pointer is not the start of a chunk");
+    const Index index = IndexOf(ptr);
+    std::memcpy(ptr, &m_head, sizeof(Index));
+    m_head = index;
+    --m_used;
+
+#ifdef _DEBUG
+    std::cout << "F" << "\t@S " << (void*) m_storage << "\t@F " << ptr << "\tI " << (std::size_t) index << std::endl;
+#endif
+}
+
+template <std::size_t ChunkSize, std::size_t Count, std::size_t Align>
+void FixedPool<ChunkSize, Count, Align>::Reset() {
+    m_head = NONE;
+    m_bump = 0;
+    m_used = 0;
+}
@@ -0,0 +1,48 @@
+#ifndef FRAMEALLOCATOR_H
+#define FRAMEALLOCATOR_H
+
+#include "Allocator.h"
+#include "LinearAllocator.h"
+#include <memory>
+#include <vector>
+
+/**
+ * @brief N-buffered linear allocator for data that lives a fixed number of frames.
+ *
+ * Rotates between nFrames linear arenas. NextFrame() moves to the next arena
+ * and resets only that one, which was last used nFrames - 1 frames ago, so
+ * whatever is allocated in frame N stays valid until NextFrame() has been
+ * called nFrames - 1 times, without copying and at the cost of one reset per
+ * frame.
+ */
+class FrameAllocator : public Allocator {
+private:
+    std::vector<std::unique_ptr<LinearAllocator>> m_frames;
+    LinearAllocator* m_currentFrame = nullptr;
+    std::size_t m_current;
+public:
+    /// Every frame gets frameSize bytes, a non-zero maxBlockSize lets a frame grow past it (see LinearAllocator).
+    FrameAllocator(const std::size_t frameSize, const std::size_t nFrames = 2, const std::size_t maxBlockSize = 0);
+
+    virtual ~FrameAllocator();
+
+    virtual void* Allocate(const std::size_t size, const std::size_t alignment = 0) override;
+
+    virtual void Free(void* ptr) override;
+    virtual bool SupportsFree() const override { return false; }
+
+    virtual void Init() override;
+
+    /// Resets every frame and starts again from the first one.
+    virtual void Reset();
+
+    /// Starts a new frame, releasing the allocations made nFrames frames ago.
+    void NextFrame();
+
+    std::size_t GetFrameCount() const { return m_frames.size(); }
+    std::size_t GetCurrentFrame() const { return m_current; }
+private:
+    FrameAllocator(FrameAllocator &frameAllocator);
+};
+
+#endif /* FRAMEALLOCATOR_H */
@@ -2,16 +2,25 @@
 #define FREELISTALLOCATOR_H
 
 #include "Allocator.h"
-#include "SinglyLinkedList.h"
+#include "DoublyLinkedList.h"
+#include "RedBlackTree.h"
+#include <cstdint>  // uint64_t
 
 class FreeListAllocator : public Allocator {
 public:
     enum PlacementPolicy {
         FIND_FIRST,
-        FIND_BEST
+        FIND_BEST,
+        // Segregated free lists: exact size bins below SMALL_BIN_LIMIT, two bins per power of two above
+        FIND_BINNED
     };
 
+    static const std::size_t SMALL_BINS = 32;
+    static const std::size_t SMALL_BIN_LIMIT = SMALL_BINS * 8;
+    static const std::size_t N_BINS = 64;
+
 private:
+    // Every block starts with its size tagged with the IN_USE and PREVIOUS_IN_USE bits
     struct FreeHeader {
         std::size_t blockSize;
     };
@@ -19,13 +28,36 @@ private:
         std::size_t blockSize;
         char padding;
     };
-    
-    typedef SinglyLinkedList<FreeHeader>::Node Node;
 
-    
+    static const std::size_t IN_USE = 1;
+    static const std::size_t PREVIOUS_IN_USE = 2;
+    static const std::size_t FLAGS = IN_USE | PREVIOUS_IN_USE;
+
+    struct FreeHeaderLess {
+        bool operator()(const FreeHeader& a, const FreeHeader& b) const { return (a.blockSize & ~FLAGS) < (b.blockSize & ~FLAGS); }
+    };
+
+    // Both kinds of node start with the FreeHeader, so a block is addressed as a Node whatever the index
+    typedef DoublyLinkedList<FreeHeader>::Node Node;
+    typedef RedBlackTree<FreeHeader, FreeHeaderLess>::Node TreeNode;
+
     void* m_start_ptr = nullptr;
     PlacementPolicy m_pPolicy;
-    SinglyLinkedList<FreeHeader> m_freeList;
+    // A free block holds its index node and a footer with its size
+    std::size_t m_minBlockSize;
+    // FIND_FIRST walks a list, FIND_BEST keeps the free blocks sorted by size in a tree
+    DoublyLinkedList<FreeHeader> m_freeList;
+    RedBlackTree<FreeHeader, FreeHeaderLess> m_freeTree;
+    // FIND_BINNED keeps one list per size bin and a bit per non-empty bin, so the search jumps to the first bin
+    // that can hold the request
+    DoublyLinkedList<FreeHeader> m_bins[N_BINS];
+    uint64_t m_binMap = 0;
+
+    // Headerless mode: used blocks carry nothing, the size comes back through FreeSized(). One bit per 8 byte
+    // granule tells free memory from used memory, which is all coalescing needs to know about a neighbour.
+    // Free blocks too small for an index node are kept out of the index until a neighbour merges with them.
+    bool m_headerless = false;
+    uint64_t* m_freeMap = nullptr;
 
 public:
     FreeListAllocator(const std::size_t totalSize, const PlacementPolicy pPolicy);
@@ -36,18 +68,65 @@ public:
 
     virtual void Free(void* ptr) override;
 
+    /// Allocate() and Free() with the placement policy fixed at compile time, so without the virtual call and the
+    /// policy checks. 'Placement' must be the policy given to the constructor, headerless mode is not supported.
+    template <PlacementPolicy Placement>
+    void* AllocateWith(const std::size_t size, const std::size_t alignment);
+    template <PlacementPolicy Placement>
+    void FreeWith(void* ptr);
+
+    /// The only way to free blocks in headerless mode, 'size' must be the one given to Allocate().
+    virtual void FreeSized(void* ptr, const std::size_t size) override;
+
+    /// Grows in place by absorbing the physically following block when it is free, shrinks in place by giving the
+    /// tail back. Otherwise moves the data to a new block. Not supported in headerless mode.
+    virtual void* Reallocate(void* ptr, const std::size_t newSize, const std::size_t alignment = 0) override;
+
     virtual void Init() override;
 
     virtual void Reset();
     std::size_t GetPeakMemoryUsage() const;
+
+    /// Must be called before Init(). Allocations then store no header, so a 24 byte object takes 24 bytes (or the
+    /// minimum block size) instead of 40, and are freed with FreeSized() only.
+    void SetHeaderlessMode();
 private:
     FreeListAllocator(FreeListAllocator &freeListAllocator);
 
-    void Coalescence(Node* prevBlock, Node * freeBlock);
+    Node* Coalescence(Node* freeNode);
+    template <PlacementPolicy Placement>
+    Node* CoalescenceWith(Node* freeNode);
+    // Gives the end of a used block back to the free blocks, from 'requiredSize' on, if it is big enough
+    void ReleaseTail(Node* block, const std::size_t requiredSize);
+
+    void* AllocateWithoutHeader(const std::size_t size, const std::size_t alignment);
+    std::size_t Padding(const std::size_t address, const std::size_t alignment) const;
+    static std::size_t HeaderlessBlockSize(const std::size_t size) { return size != 0 ? (size + 7) & ~(std::size_t)7 : 8; }
+    // Headerless mode: free blocks are indexed only when they can hold an index node
+    void AddFree(Node* block, const std::size_t blockSize);
+    void RemoveFreeIfIndexed(Node* block);
+    bool IsFreeGranule(const std::size_t address) const;
+    void MarkGranules(const std::size_t address, const std::size_t size, const bool free);
+
+    void Find(const std::size_t size, const std::size_t alignment, std::size_t& padding, Node*& foundNode);
+    template <PlacementPolicy Placement>
+    void FindWith(const std::size_t size, const std::size_t alignment, std::size_t& padding, Node*& foundNode);
+    void FindBest(const std::size_t size, const std::size_t alignment, std::size_t& padding, Node*& foundNode);
+    void FindFirst(const std::size_t size, const std::size_t alignment, std::size_t& padding, Node*& foundNode);
+    void FindBinned(const std::size_t size, const std::size_t alignment, std::size_t& padding, Node*& foundNode);
+    static std::size_t BinIndex(const std::size_t blockSize);
+
+    void InsertFree(Node* block);
+    void RemoveFree(Node* block);
+    template <PlacementPolicy Placement>
+    void InsertFreeWith(Node* block);
+    template <PlacementPolicy Placement>
+    void RemoveFreeWith(Node* block);
+
+    void SetFreeBlock(Node* block, const std::size_t blockSize);
+    Node* NextBlock(const Node* block) const;
 
-    void Find(const std::size_t size, const std::size_t alignment, std::size_t& padding, Node*& previousNode, Node*& foundNode);
-    void FindBest(const std::size_t size, const std::size_t alignment, std::size_t& padding, Node*& previousNode, Node*& foundNode);
-    void FindFirst(const std::size_t size, const std::size_t alignment, std::size_t& padding, Node*& previousNode, Node*& foundNode);
+    static std::size_t BlockSize(const Node* block) { return block->data.blockSize & ~FLAGS; }
 };
 
 #endif /* FREELISTALLOCATOR_H */
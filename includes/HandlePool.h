@@ -0,0 +1,99 @@
+#ifndef HANDLEPOOL_H
+#define HANDLEPOOL_H
+
+#include "RegionProvider.h"
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t
+
+/**
+ * @brief Pool of T objects referenced by 32-bit generational handles.
+ *
+ * A handle packs a slot index in its low IndexBits and the slot generation in
+ * the rest. Destroying an object bumps the generation of its slot, so handles
+ * kept after Destroy() are detected by Get() instead of reaching the object
+ * that reuses the slot. The null handle (0) is never valid.
+ *
+ * Live objects are kept packed in a dense array: Destroy() moves the last one
+ * into the hole, so begin()/end() walk live objects in memory order. Pointers
+ * returned by Get() are therefore only stable until the next Destroy().
+ */
+template <class T, unsigned IndexBits = 20>
+class HandlePool {
+    static_assert(IndexBits > 0 && IndexBits < 32, "Handles need room for both an index and a generation");
+public:
+    class Handle {
+    private:
+        uint32_t m_value;
+    public:
+        constexpr Handle() : m_value{0} {}
+        constexpr explicit Handle(const uint32_t value) : m_value{value} {}
+
+        uint32_t GetValue() const { return m_value; }
+        uint32_t GetIndex() const { return m_value & INDEX_MASK; }
+        uint32_t GetGeneration() const { return m_value >> IndexBits; }
+        bool IsNull() const { return m_value == 0; }
+
+        bool operator==(const Handle& other) const { return m_value == other.m_value; }
+        bool operator!=(const Handle& other) const { return m_value != other.m_value; }
+    };
+
+    static constexpr uint32_t INDEX_MASK = (1u << IndexBits) - 1;
+    static constexpr uint32_t GENERATION_MASK = ~0u >> IndexBits;
+    static constexpr std::size_t MAX_CAPACITY = (std::size_t) 1 << IndexBits;
+private:
+    struct Slot {
+        uint32_t generation;
+        // Position in the dense array while the slot is live, next free slot otherwise
+        uint32_t denseOrNext;
+    };
+
+    static const uint32_t NONE = ~0u;
+
+    RegionProvider* m_regionProvider;
+    std::size_t m_capacity;
+    std::size_t m_regionSize;
+    void* m_region = nullptr;
+
+    T* m_dense = nullptr;
+    // Slot of every dense object, to patch it when the object moves
+    uint32_t* m_denseToSlot = nullptr;
+    Slot* m_slots = nullptr;
+    std::size_t m_size = 0;
+    uint32_t m_freeSlot = NONE;
+public:
+    HandlePool(const std::size_t capacity);
+
+    ~HandlePool();
+
+    /// Destroys the live objects and starts over with every slot free.
+    void Init();
+
+    /// Constructs a T in place, returns the null handle when the pool is full.
+    template <class... Args>
+    Handle Create(Args&&... args);
+
+    /// The handle must be valid.
+    void Destroy(const Handle handle);
+
+    bool IsValid(const Handle handle) const;
+
+    /// Returns nullptr for the null handle and for handles whose object was destroyed.
+    T* Get(const Handle handle) const { return IsValid(handle) ? m_dense + m_slots[handle.GetIndex()].denseOrNext : nullptr; }
+
+    /// Handle of the object at position 'denseIndex' of the iteration order.
+    Handle HandleAt(const std::size_t denseIndex) const;
+
+    std::size_t GetSize() const { return m_size; }
+    std::size_t GetCapacity() const { return m_capacity; }
+
+    T* begin() const { return m_dense; }
+    T* end() const { return m_dense + m_size; }
+private:
+    HandlePool(HandlePool &handlePool);
+
+    void Release();
+};
+
+#include "HandlePoolImpl.h"
+
+#endif /* HANDLEPOOL_H */
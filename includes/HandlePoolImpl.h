@@ -0,0 +1,117 @@
+#include "HandlePool.h"
+#include <cassert> /* assert */
+#include <new> /* placement new */
+#include <utility> /* forward, move */
+#ifdef _DEBUG
+#include <iostream>
+#endif
+
+template <class T, unsigned IndexBits>
+HandlePool<T, IndexBits>::HandlePool(const std::size_t capacity)
+: m_regionProvider{RegionProvider::GetDefault()}, m_capacity{capacity} {
+    assert(capacity > 0 && capacity <= MAX_CAPACITY && "Capacity does not fit in the handle index");
+    // Dense objects, then the dense to slot table, then the slots
+    const std::size_t tablesOffset = (capacity * sizeof(T) + alignof(Slot) - 1) & ~(alignof(Slot) - 1);
+    m_regionSize = tablesOffset + capacity * (sizeof(uint32_t) + sizeof(Slot));
+}
+
+template <class T, unsigned IndexBits>
+HandlePool<T, IndexBits>::~HandlePool() {
+    Release();
+}
+
+template <class T, unsigned IndexBits>
+void HandlePool<T, IndexBits>::Release() {
+    if (m_region == nullptr) {
+        return;
+    }
+    for (std::size_t i = 0; i < m_size; ++i) {
+        m_dense[i].~T();
+    }
+    m_regionProvider->Free(m_region, m_regionSize);
+    m_region = nullptr;
+    m_size = 0;
+}
+
+template <class T, unsigned IndexBits>
+void HandlePool<T, IndexBits>::Init() {
+    Release();
+    const std::size_t alignment = alignof(T) > alignof(Slot) ? alignof(T) : alignof(Slot);
+    m_region = m_regionProvider->Allocate(m_regionSize, alignment);
+    m_dense = (T*) m_region;
+    m_slots = (Slot*) ((std::size_t) m_region + m_regionSize - m_capacity * sizeof(Slot));
+    m_denseToSlot = (uint32_t*) ((std::size_t) m_slots - m_capacity * sizeof(uint32_t));
+
+    // Generations start at 1 so that no valid handle is null
+    for (std::size_t i = 0; i < m_capacity; ++i) {
+        m_slots[i].generation = 1;
+        m_slots[i].denseOrNext = i + 1 < m_capacity ? (uint32_t) (i + 1) : NONE;
+    }
+    m_freeSlot = 0;
+}
+
+template <class T, unsigned IndexBits>
+template <class... Args>
+typename HandlePool<T, IndexBits>::Handle HandlePool<T, IndexBits>::Create(Args&&... args) {
+    if (m_freeSlot == NONE) {
+        return Handle();
+    }
+    const uint32_t index = m_freeSlot;
+    Slot& slot = m_slots[index];
+    new (m_dense + m_size) T(std::forward<Args>(args)...);
+    m_freeSlot = slot.denseOrNext;
+    slot.denseOrNext = (uint32_t) m_size;
+    m_denseToSlot[m_size] = index;
+    ++m_size;
+
+    const Handle handle((slot.generation << IndexBits) | index);
+#ifdef _DEBUG
+    std::cout << "C" << "\t@S " << m_region << "\tH " << handle.GetValue() << "\tD " << slot.denseOrNext << std::endl;
+#endif
+    return handle;
+}
+
+template <class T, unsigned IndexBits>
+void HandlePool<T, IndexBits>::Destroy(const Handle handle) {
+    assert(IsValid(handle) && "Handle is null or its object was already destroyed");
+    const uint32_t index = handle.GetIndex();
+    Slot& slot = m_slots[index];
+    const uint32_t dense = slot.denseOrNext;
+
+    // Fill the hole with the last object so the live ones stay packed
+    const uint32_t last = (uint32_t) m_size - 1;
+    if (dense != last) {
+        m_dense[dense] = std::move(m_dense[last]);
+        m_denseToSlot[dense] = m_denseToSlot[last];
+        m_slots[m_denseToSlot[dense]].denseOrNext = dense;
+    }
+    m_dense[last].~T();
+    --m_size;
+
+    // Stale handles stop matching, skipping 0 keeps the null handle invalid
+    slot.generation = (slot.generation + 1) & GENERATION_MASK;
+    if (slot.generation == 0) {
+        slot.generation = 1;
+    }
+    slot.denseOrNext = m_freeSlot;
+    m_freeSlot = index;
+
+#ifdef _DEBUG
+    std::cout << "D" << "\t@S " << m_region << "\tH " << handle.GetValue() << "\tD " << dense << std::endl;
+#endif
+}
+
+template <class T, unsigned IndexBits>
+bool HandlePool<T, IndexBits>::IsValid(const Handle handle) const {
+    const uint32_t index = handle.GetIndex();
+    // Destroyed objects fail the generation check, never used slots fail the dense one
+    return !handle.IsNull() && index < m_capacity && m_slots[index].generation == handle.GetGeneration()
+        && m_slots[index].denseOrNext < m_size && m_denseToSlot[m_slots[index].denseOrNext] == index;
+}
+
+template <class T, unsigned IndexBits>
+typename HandlePool<T, IndexBits>::Handle HandlePool<T, IndexBits>::HandleAt(const std::size_t denseIndex) const {
+    assert(denseIndex < m_size && "Index past the live objects");
+    const uint32_t index = m_denseToSlot[denseIndex];
+    return Handle((m_slots[index].generation << IndexBits) | index);
+}
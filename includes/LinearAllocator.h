@@ -2,27 +2,90 @@
 #define LINEARALLOCATOR_H
 
 #include "Allocator.h"
+#include "VirtualArena.h"
 
 class LinearAllocator : public Allocator {
 protected:
+	// Chained blocks start with this header, the data follows it
+	struct BlockHeader {
+		BlockHeader* previous;
+		std::size_t size;
+	};
+
 	void* m_start_ptr = nullptr;
 	std::size_t m_offset;
+	// Backs the first block
+	VirtualArena m_arena;
+	bool m_reserve = false;
+	std::size_t m_retainedSize;
+
+	// Block the offset refers to: the first one (m_start_ptr) or the newest chained block
+	void* m_current_ptr = nullptr;
+	std::size_t m_currentSize;
+	BlockHeader* m_currentBlock = nullptr;
+	// Chained mode is enabled by a non-zero maximum block size
+	std::size_t m_maxBlockSize;
+	bool m_keepLargest;
+	BlockHeader* m_spareBlock = nullptr;
+	// Bytes used in the chained blocks that were filled before the current one
+	std::size_t m_retiredUsed;
+	// The only allocation Reallocate() can resize in place, nullptr once the offset was rewound
+	void* m_lastAllocation = nullptr;
 public:
+	// Position in the allocator, everything allocated after it is released by FreeToMarker()
+	struct Marker {
+		BlockHeader* block;
+		std::size_t offset;
+		std::size_t retiredUsed;
+	};
+
 	LinearAllocator(const std::size_t totalSize);
 
+	/// Chained mode: when the current block is exhausted a new one is allocated, each twice as big as the previous
+	/// one but never bigger than maxBlockSize (unless a single allocation needs it). Reset() keeps the first block
+	/// and, if keepLargest is set, the largest chained block for the next round.
+	LinearAllocator(const std::size_t totalSize, const std::size_t maxBlockSize, const bool keepLargest = true);
+
 	virtual ~LinearAllocator();
 
 	virtual void* Allocate(const std::size_t size, const std::size_t alignment = 0) override;
 
+	/// Resizes the most recent allocation in place by moving the offset. Any other block, or one that no longer
+	/// fits in its block, is copied to a new allocation and the old space is only reclaimed by Reset().
+	virtual void* Reallocate(void* ptr, const std::size_t newSize, const std::size_t alignment = 0) override;
+
+	/// Hands out the whole batch with a single bump of the offset.
+	virtual std::size_t AllocateBatch(const std::size_t size, const std::size_t count, void** out, const std::size_t alignment = 0) override;
+
 	void Deallocate();
 
 	virtual void Free(void* ptr) override;
+	virtual bool SupportsFree() const override { return false; }
 
 	virtual void Init() override;
-LinearAllocator::Deallocate()
 	virtual void Reset();
+
+	/// Must be called before Init(). The first block is then only reserved and committed as the offset grows,
+	/// Reset() decommits everything above retainedSize.
+	void SetReserveMode(const std::size_t retainedSize);
+
+	Marker GetMarker() const { return Marker{m_currentBlock, m_offset, m_retiredUsed}; }
+
+	/// Releases every allocation made since the marker was taken. Chained blocks created since then are freed
+	/// following the same rule as Reset().
+	void FreeToMarker(const Marker& marker);
+
+	/// Linear allocations never carry a header, this is Allocate() without the virtual call.
+	void* AllocateHeaderless(const std::size_t size, const std::size_t alignment = 0) { return LinearAllocator::Allocate(size, alignment); }
 private:
 	LinearAllocator(LinearAllocator &linearAllocator);
+
+	bool Grow(const std::size_t minSize);
+	// Frees the chained blocks newer than 'last' (all of them for nullptr) and makes 'last' current
+	void ReleaseBlocks(BlockHeader* last, const bool keepSpare);
+	// Bytes from 'ptr' to the end of the memory handed out in its block, a bound on the size of the allocation
+	std::size_t ExtentFrom(const void* ptr) const;
+	void FreeBlock(BlockHeader* block) { m_regionProvider->Free(block, sizeof(BlockHeader) + block->size); }
 };
 
 #endif /* LINEARALLOCATOR_H */
@@ -0,0 +1,39 @@
+#ifndef LOCKEDALLOCATOR_H
+#define LOCKEDALLOCATOR_H
+
+#include "Allocator.h"
+#include <memory>
+#include <mutex>
+
+/**
+ * @brief Serializes every call to a wrapped allocator behind one mutex.
+ *
+ * This is the "global lock" baseline that the thread-aware allocators are
+ * measured against. Statistics mirror the wrapped allocator.
+ */
+class LockedAllocator : public Allocator {
+private:
+    std::unique_ptr<Allocator> m_allocator;
+    std::mutex m_mutex;
+public:
+    LockedAllocator(std::unique_ptr<Allocator> allocator);
+
+    virtual ~LockedAllocator();
+
+    virtual void* Allocate(const std::size_t size, const std::size_t alignment = 0) override;
+
+    virtual void Free(void* ptr) override;
+    virtual void FreeSized(void* ptr, const std::size_t size) override;
+    virtual bool SupportsFree() const override { return m_allocator->SupportsFree(); }
+    virtual void* Reallocate(void* ptr, const std::size_t newSize, const std::size_t alignment = 0) override;
+
+    // A whole batch costs a single lock round trip
+    virtual std::size_t AllocateBatch(const std::size_t size, const std::size_t count, void** out, const std::size_t alignment = 0) override;
+    virtual void FreeBatch(void** ptrs, const std::size_t count) override;
+
+    virtual void Init() override;
+private:
+    LockedAllocator(LockedAllocator &lockedAllocator);
+};
+
+#endif /* LOCKEDALLOCATOR_H */
@@ -0,0 +1,99 @@
+#ifndef OWNERPOOLALLOCATOR_H
+#define OWNERPOOLALLOCATOR_H
+
+#include "Allocator.h"
+#include <atomic>
+#include <mutex>
+
+/**
+ * @brief Pool whose spans belong to threads, with lock-free remote frees in the style of mimalloc.
+ *
+ * The region is cut into spanSize aligned spans, taken by threads as they need
+ * them. A span is only allocated from by its owner: chunks freed by the owner
+ * go to the span's local free list, chunks freed by any other thread are
+ * pushed on the span's atomic remote list. When its local list runs dry the
+ * owner takes the whole remote list with one exchange, so a producer thread
+ * that allocates and consumer threads that free never share a lock.
+ *
+ * Spans are not handed back until Reset(); a thread reusing the index of an
+ * exited one (see ThreadRegistry) inherits its spans. Allocate returns nullptr
+ * when the region has no span left, or to threads past the first maxThreads
+ * live ones, which have no heap; their frees are remote frees. GetPeak()
+ * reports the bytes carved from the region.
+ */
+class OwnerPoolAllocator : public Allocator {
+private:
+    struct Node {
+        Node* next;
+    };
+
+    struct SpanHeader {
+        std::size_t owner;
+        // Next span of the same owner
+        SpanHeader* next;
+        Node* localFree;
+        // Chunks are carved lazily, past this offset the span has never been used
+        std::size_t bumpOffset;
+        // Written by other threads, kept off the cache line of the owner's fields
+        alignas(64) std::atomic<Node*> remoteFree;
+    };
+
+    struct ThreadHeap {
+        // Keeps the heaps of two threads on different cache lines
+        char padding[64];
+        SpanHeader* current;
+        SpanHeader* spans;
+        // Written by the owning thread only, read by GetUsed()
+        std::atomic<std::size_t> allocatedChunks;
+        std::atomic<std::size_t> freedChunks;
+    };
+
+    void* m_start_ptr = nullptr;
+    std::size_t m_chunkSize;
+    std::size_t m_spanSize;
+    std::size_t m_spanOffset;
+    std::size_t m_nSpans;
+    std::size_t m_maxThreads;
+    ThreadHeap* m_heaps = nullptr;
+    // Frees by threads without a heap
+    std::atomic<std::size_t> m_outsideFreedChunks{0};
+
+    mutable std::mutex m_spanMutex;
+    std::size_t m_nextSpan;
+
+public:
+    /// 'spanSize' is a power of two, 'totalSize' a multiple of it.
+    OwnerPoolAllocator(const std::size_t totalSize, const std::size_t chunkSize, const std::size_t spanSize = 65536, const std::size_t maxThreads = 64);
+
+    virtual ~OwnerPoolAllocator();
+
+    virtual void* Allocate(const std::size_t size, const std::size_t alignment = 0) override;
+
+    /// Any thread may free any chunk.
+    virtual void Free(void* ptr) override;
+
+    virtual void Init() override;
+
+    /// Not thread safe, every span goes back to the region.
+    virtual void Reset();
+
+    virtual std::size_t GetUsed() const override;
+    virtual std::size_t GetPeak() const override;
+
+    /// Number of spans taken by the calling thread.
+    std::size_t GetOwnedSpanCount() const;
+private:
+    OwnerPoolAllocator(OwnerPoolAllocator &ownerPoolAllocator);
+
+    Node* AllocateFromSpan(SpanHeader* span);
+    /// Moves the heap to a span with a free chunk, reclaiming remote frees or taking a new span.
+    SpanHeader* FindSpan(ThreadHeap& heap, const std::size_t owner);
+    SpanHeader* AcquireSpan(const std::size_t owner);
+    bool HasFreeChunk(SpanHeader* span) const {
+        return span->localFree != nullptr || span->bumpOffset + m_chunkSize <= m_spanSize || span->remoteFree.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    SpanHeader* SpanOf(const void* ptr) const { return (SpanHeader*) ((std::size_t) ptr & ~(m_spanSize - 1)); }
+};
+
+#endif /* OWNERPOOLALLOCATOR_H */
@@ -1,3 +1,6 @@
+#ifndef POOLALLOCATOR_H
+#define POOLALLOCATOR_H
+
 #include "Allocator.h"
 #include "StackLinkedList.h"
 
@@ -8,21 +11,69 @@ private:
     using Node = StackLinkedList<FreeHeader>::Node;
     StackLinkedList<FreeHeader> m_freeList;
 
+    // Header at the start of every span-aligned span acquired once the initial region is exhausted
+    struct SpanHeader {
+        SpanHeader* previous;
+        SpanHeader* next;
+        Node* freeList;
+        // Chunks are carved lazily, past this offset the span has never been used
+        std::size_t bumpOffset;
+        std::size_t usedChunks;
+    };
+
     void * m_start_ptr = nullptr;
     std::size_t m_chunkSize;
+
+    // Growth is enabled by a non-zero span size
+    std::size_t m_spanSize;
+    std::size_t m_spanOffset;
+    std::size_t m_chunksPerSpan;
+    // Spans with free chunks are kept in front of the full ones
+    SpanHeader* m_spans = nullptr;
+    // Fully free spans kept before releasing them to the OS
+    std::size_t m_maxEmptySpans;
+    std::size_t m_emptySpans;
+    std::size_t m_nSpans;
 public:
     PoolAllocator(const std::size_t totalSize, const std::size_t chunkSize);
 
+    /// Growing pool: when the initial region is exhausted, spans of spanSize bytes (a power of two) are acquired
+    /// on demand. Spans that become fully free are released once more than maxEmptySpans of them are cached.
+    PoolAllocator(const std::size_t totalSize, const std::size_t chunkSize, const std::size_t spanSize, const std::size_t maxEmptySpans);
+
     virtual ~PoolAllocator();
 
     virtual void* Allocate(const std::size_t size, const std::size_t alignment = 0) override;
 
     virtual void Free(void* ptr) override;
 
+    /// Unlike Allocate(), returns fewer chunks instead of asserting when the pool is exhausted.
+    virtual std::size_t AllocateBatch(const std::size_t size, const std::size_t count, void** out, const std::size_t alignment = 0) override;
+
+    virtual void FreeBatch(void** ptrs, const std::size_t count) override;
+
     virtual void Init() override;
 
     virtual void Reset();
+
+    void* GetStartPtr() const { return m_start_ptr; }
+    std::size_t GetSpanCount() const { return m_nSpans; }
 private:
     PoolAllocator(PoolAllocator &poolAllocator);
 
-};
\ No newline at end of file
+    Node* AllocateFromSpans();
+    void FreeToSpan(Node* node);
+
+    SpanHeader* AcquireSpan();
+    void ReleaseSpan(SpanHeader* span);
+    void ReleaseSpans();
+
+    void LinkSpanFront(SpanHeader* span);
+    void LinkSpanBack(SpanHeader* span);
+    void UnlinkSpan(SpanHeader* span);
+
+    bool InInitialRegion(const void* ptr) const { return (std::size_t) ptr - (std::size_t) m_start_ptr < m_totalSize; }
+    SpanHeader* SpanOf(const void* ptr) const { return (SpanHeader*) ((std::size_t) ptr & ~(m_spanSize - 1)); }
+};
+
+#endif /* POOLALLOCATOR_H */
@@ -0,0 +1,47 @@
+#ifndef REDBLACKTREE_H
+#define REDBLACKTREE_H
+
+/**
+ * Intrusive red-black tree. Nodes are owned by the caller (for allocators, they
+ * live inside the free blocks themselves). Nodes are ordered by their data
+ * using Compare, and nodes with equal data by their address.
+ */
+template <class T, class Compare>
+class RedBlackTree {
+public:
+    struct Node {
+        T data;
+        Node* parent;
+        Node* left;
+        Node* right;
+        bool red;
+    };
+
+    Node* root;
+
+public:
+    RedBlackTree();
+
+    void insert(Node* newNode);
+    void remove(Node* deleteNode);
+
+    // Smallest node whose data is not less than key, the lowest address among equals
+    Node* lowerBound(const T& key) const;
+    static Node* successor(Node* node);
+private:
+    RedBlackTree(RedBlackTree &redBlackTree);
+
+    bool less(const Node* a, const Node* b) const;
+
+    void rotateLeft(Node* node);
+    void rotateRight(Node* node);
+    void transplant(Node* oldNode, Node* newNode);
+    void insertFixup(Node* node);
+    void removeFixup(Node* node, Node* parent);
+
+    static Node* minimum(Node* node);
+};
+
+#include "RedBlackTreeImpl.h"
+
+#endif /* REDBLACKTREE_H */
@@ -0,0 +1,266 @@
+#include "RedBlackTree.h"
+
+template <class T, class Compare>
+RedBlackTree<T, Compare>::RedBlackTree() : root{nullptr} {
+
+}
+
+template <class T, class Compare>
+bool RedBlackTree<T, Compare>::less(const Node* a, const Node* b) const {
+    if (Compare()(a->data, b->data)) {
+        return true;
+    }
+    if (Compare()(b->data, a->data)) {
+        return false;
+    }
+    return a < b;
+}
+
+template <class T, class Compare>
+void RedBlackTree<T, Compare>::insert(Node* newNode) {
+    Node* parent = nullptr;
+    Node* it = root;
+    while (it != nullptr) {
+        parent = it;
+        it = less(newNode, it) ? it->left : it->right;
+    }
+
+    newNode->parent = parent;
+    newNode->left = nullptr;
+    newNode->right = nullptr;
+    newNode->red = true;
+    if (parent == nullptr) {
+        root = newNode;
+    } else if (less(newNode, parent)) {
+        parent->left = newNode;
+    } else {
+        parent->right = newNode;
+    }
+
+    insertFixup(newNode);
+}
+
+template <class T, class Compare>
+void RedBlackTree<T, Compare>::remove(Node* deleteNode) {
+    Node* replacement = deleteNode;
+    bool removedRed = replacement->red;
+    Node* child;
+    Node* childParent;
+
+    if (deleteNode->left == nullptr) {
+        child = deleteNode->right;
+        childParent = deleteNode->parent;
+        transplant(deleteNode, deleteNode->right);
+    } else if (deleteNode->right == nullptr) {
+        child = deleteNode->left;
+        childParent = deleteNode->parent;
+        transplant(deleteNode, deleteNode->left);
+    } else {
+        // Two children: the in-order successor takes the place of the removed node
+        replacement = minimum(deleteNode->right);
+        removedRed = replacement->red;
+        child = replacement->right;
+        if (replacement->parent == deleteNode) {
+            childParent = replacement;
+        } else {
+            childParent = replacement->parent;
+            transplant(replacement, replacement->right);
+            replacement->right = deleteNode->right;
+            replacement->right->parent = replacement;
+        }
+        transplant(deleteNode, replacement);
+        replacement->left = deleteNode->left;
+        replacement->left->parent = replacement;
+        replacement->red = deleteNode->red;
+    }
+
+    if (!removedRed) {
+        removeFixup(child, childParent);
+    }
+}
+
+template <class T, class Compare>
+typename RedBlackTree<T, Compare>::Node* RedBlackTree<T, Compare>::lowerBound(const T& key) const {
+    Node* result = nullptr;
+    Node* it = root;
+    while (it != nullptr) {
+        if (Compare()(it->data, key)) {
+            it = it->right;
+        } else {
+            result = it;
+            it = it->left;
+        }
+    }
+    return result;
+}
+
+template <class T, class Compare>
+typename RedBlackTree<T, Compare>::Node* RedBlackTree<T, Compare>::successor(Node* node) {
+    if (node->right != nullptr) {
+        return minimum(node->right);
+    }
+    Node* parent = node->parent;
+    while (parent != nullptr && node == parent->right) {
+        node = parent;
+        parent = parent->parent;
+    }
+    return parent;
+}
+
+template <class T, class Compare>
+typename RedBlackTree<T, Compare>::Node* RedBlackTree<T, Compare>::minimum(Node* node) {
+    while (node->left != nullptr) {
+        node = node->left;
+    }
+    return node;
+}
+
+template <class T, class Compare>
+void RedBlackTree<T, Compare>::rotateLeft(Node* node) {
+    Node* pivot = node->right;
+    node->right = pivot->left;
+    if (pivot->left != nullptr) {
+        pivot->left->parent = node;
+    }
+    transplant(node, pivot);
+    pivot->left = node;
+    node->parent = pivot;
+}
+
+template <class T, class Compare>
+void RedBlackTree<T, Compare>::rotateRight(Node* node) {
+    Node* pivot = node->left;
+    node->left = pivot->right;
+    if (pivot->right != nullptr) {
+        pivot->right->parent = node;
+    }
+    transplant(node, pivot);
+    pivot->right = node;
+    node->parent = pivot;
+}
+
+template <class T, class Compare>
+void RedBlackTree<T, Compare>::transplant(Node* oldNode, Node* newNode) {
+    if (oldNode->parent == nullptr) {
+        root = newNode;
+    } else if (oldNode == oldNode->parent->left) {
+        oldNode->parent->left = newNode;
+    } else {
+        oldNode->parent->right = newNode;
+    }
+    if (newNode != nullptr) {
+        newNode->parent = oldNode->parent;
+    }
+}
+
+template <class T, class Compare>
+void RedBlackTree<T, Compare>::insertFixup(Node* node) {
+    while (node->parent != nullptr && node->parent->red) {
+        Node* parent = node->parent;
+        // A red node is never the root, so the grandparent exists
+        Node* grandparent = parent->parent;
+        if (parent == grandparent->left) {
+            Node* uncle = grandparent->right;
+            if (uncle != nullptr && uncle->red) {
+                parent->red = false;
+                uncle->red = false;
+                grandparent->red = true;
+                node = grandparent;
+            } else {
+                if (node == parent->right) {
+                    node = parent;
+                    rotateLeft(node);
+                    parent = node->parent;
+                }
+                parent->red = false;
+                grandparent->red = true;
+                rotateRight(grandparent);
+            }
+        } else {
+            Node* uncle = grandparent->left;
+            if (uncle != nullptr && uncle->red) {
+                parent->red = false;
+                uncle->red = false;
+                grandparent->red = true;
+                node = grandparent;
+            } else {
+                if (node == parent->left) {
+                    node = parent;
+                    rotateRight(node);
+                    parent = node->parent;
+                }
+                parent->red = false;
+                grandparent->red = true;
+                rotateLeft(grandparent);
+            }
+        }
+    }
+    root->red = false;
+}
+
+template <class T, class Compare>
+void RedBlackTree<T, Compare>::removeFixup(Node* node, Node* parent) {
+    // 'node' carries an extra black and may be null, so its parent is tracked separately
+    while (node != root && (node == nullptr || !node->red)) {
+        if (node == parent->left) {
+            Node* sibling = parent->right;
+            if (sibling->red) {
+                sibling->red = false;
+                parent->red = true;
+                rotateLeft(parent);
+                sibling = parent->right;
+            }
+            if ((sibling->left == nullptr || !sibling->left->red) && (sibling->right == nullptr || !sibling->right->red)) {
+                sibling->red = true;
+                node = parent;
+                parent = node->parent;
+            } else {
+                if (sibling->right == nullptr || !sibling->right->red) {
+                    sibling->left->red = false;
+                    sibling->red = true;
+                    rotateRight(sibling);
+                    sibling = parent->right;
+                }
+                sibling->red = parent->red;
+                parent->red = false;
+                if (sibling->right != nullptr) {
+                    sibling->right->red = false;
+                }
+                rotateLeft(parent);
+                node = root;
+                parent = nullptr;
+            }
+        } else {
+            Node* sibling = parent->left;
+            if (sibling->red) {
+                sibling->red = false;
+                parent->red = true;
+                rotateRight(parent);
+                sibling = parent->left;
+            }
+            if ((sibling->left == nullptr || !sibling->left->red) && (sibling->right == nullptr || !sibling->right->red)) {
+                sibling->red = true;
+                node = parent;
+                parent = node->parent;
+            } else {
+                if (sibling->left == nullptr || !sibling->left->red) {
+                    sibling->right->red = false;
+                    sibling->red = true;
+                    rotateLeft(sibling);
+                    sibling = parent->left;
+                }
+                sibling->red = parent->red;
+                parent->red = false;
+                if (sibling->left != nullptr) {
+                    sibling->left->red = false;
+                }
+                rotateRight(parent);
+                node = root;
+                parent = nullptr;
+            }
+        }
+    }
+    if (node != nullptr) {
+        node->red = false;
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef REGIONPROVIDER_H
+#define REGIONPROVIDER_H
+
+#include <cstddef> // size_t
+
+/**
+ * @brief Source of the big backing regions allocators carve their memory from.
+ *
+ * Every allocator asks its provider for its region in Init() instead of calling
+ * malloc directly, so the same allocator can run on top of malloc, anonymous
+ * mmap or huge pages. The backends are stateless singletons; the default one
+ * is picked up by every allocator at construction.
+ *
+ * Regions can also be reserved without being backed: the mapped backends then
+ * hand out address space only, which is committed and decommitted page by page
+ * as the owner grows and shrinks. The malloc backend commits on Reserve.
+ */
+class RegionProvider {
+public:
+    enum Backend {
+        MALLOC,
+        // Anonymous private mapping, page aligned and returned to the OS on Free
+        MMAP,
+        // Explicit huge pages from the hugetlbfs pool, falls back to MMAP when the pool is empty
+        HUGETLB,
+        // 2MB aligned mapping advised with MADV_HUGEPAGE so the kernel backs it with transparent huge pages
+        THP
+    };
+
+    static const std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    virtual ~RegionProvider() {}
+
+    /// Returns 'size' bytes aligned to 'alignment' (a power of two, 0 for the backend's natural alignment) or nullptr.
+    virtual void* Allocate(const std::size_t size, const std::size_t alignment = 0) = 0;
+
+    /// 'size' must be the one given to Allocate.
+    virtual void Free(void* ptr, const std::size_t size) = 0;
+
+    /// Reserves 'size' bytes of address space, released with Free. Nothing may be touched before it is committed.
+    virtual void* Reserve(const std::size_t size, const std::size_t alignment = 0) { return Allocate(size, alignment); }
+
+    /// Backs a reserved range with memory. The range must be aligned to GetCommitGranularity().
+    virtual bool Commit(void* ptr, const std::size_t size) { return true; }
+
+    /// Gives the physical memory of a committed range back to the OS, its content is lost.
+    virtual void Decommit(void* ptr, const std::size_t size) {}
+
+    virtual std::size_t GetCommitGranularity() const { return GetPageSize(); }
+
+    virtual const char* GetName() const = 0;
+
+    static RegionProvider* Get(const Backend backend);
+
+    /// Parses a backend name as printed by GetName(), returns false if it is unknown.
+    static bool FromName(const char* name, Backend& backend);
+
+    static RegionProvider* GetDefault();
+    /// Only affects allocators constructed afterwards.
+    static void SetDefault(RegionProvider* provider);
+
+    static std::size_t GetPageSize();
+};
+
+#endif /* REGIONPROVIDER_H */
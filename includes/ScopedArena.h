@@ -0,0 +1,35 @@
+#ifndef SCOPEDARENA_H
+#define SCOPEDARENA_H
+
+#include <cstddef> // size_t
+
+/**
+ * @brief Releases everything allocated from a Stack or Linear allocator during its lifetime.
+ *
+ * Takes a marker on construction and rewinds to it on destruction, so a nested
+ * phase can allocate as much as it wants and discard it all in one step.
+ * Allocations go through AllocateHeaderless(), they must not outlive the scope
+ * and must not be freed individually.
+ */
+template <class T>
+class ScopedArena {
+private:
+    T& m_allocator;
+    const typename T::Marker m_marker;
+public:
+    explicit ScopedArena(T& allocator);
+
+    ~ScopedArena();
+
+    void* Allocate(const std::size_t size, const std::size_t alignment = 0);
+
+    /// Rewinds to the scope start without leaving it.
+    void Release();
+private:
+    ScopedArena(ScopedArena &scopedArena);
+    ScopedArena& operator=(const ScopedArena &scopedArena);
+};
+
+#include "ScopedArenaImpl.h"
+
+#endif /* SCOPEDARENA_H */
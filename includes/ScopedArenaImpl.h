@@ -0,0 +1,21 @@
+#include "ScopedArena.h"
+
+template <class T>
+ScopedArena<T>::ScopedArena(T& allocator)
+: m_allocator(allocator), m_marker(allocator.GetMarker()) {
+}
+
+template <class T>
+ScopedArena<T>::~ScopedArena() {
+    m_allocator.FreeToMarker(m_marker);
+}
+
+template <class T>
+void* ScopedArena<T>::Allocate(const std::size_t size, const std::size_t alignment) {
+    return m_allocator.AllocateHeaderless(size, alignment);
+}
+
+template <class T>
+void ScopedArena<T>::Release() {
+    m_allocator.FreeToMarker(m_marker);
+}
@@ -0,0 +1,78 @@
+#ifndef SHARDEDALLOCATOR_H
+#define SHARDEDALLOCATOR_H
+
+#include "Allocator.h"
+#include "FreeListAllocator.h"
+#include <mutex>
+
+/**
+ * @brief One FreeListAllocator arena per CPU, each behind its own mutex.
+ *
+ * A thread allocates from the shard of the CPU it runs on, found with
+ * sched_getcpu(), so threads only contend when they share a CPU, however many
+ * of them the pool runs. When that shard is locked the neighbouring ones are
+ * tried without blocking before waiting on it. The shards slice one region
+ * evenly, so Free() finds the owning shard from the address alone, whichever
+ * thread or CPU frees the block.
+ *
+ * When the shard is full the others are tried in turn, Allocate() returns
+ * nullptr only when none of them has room.
+ * Statistics are the sums over the shards, the peak is therefore an upper bound.
+ */
+class ShardedAllocator : public Allocator {
+private:
+    // Hands the same slice of the sharded region to a shard every time it initializes
+    class SliceRegionProvider : public RegionProvider {
+    private:
+        void* m_slice = nullptr;
+        std::size_t m_size = 0;
+    public:
+        void SetSlice(void* slice, const std::size_t size) { m_slice = slice; m_size = size; }
+        virtual void* Allocate(const std::size_t size, const std::size_t alignment = 0) override { return size <= m_size ? m_slice : nullptr; }
+        virtual void Free(void* ptr, const std::size_t size) override {}
+        virtual const char* GetName() const override { return "slice"; }
+    };
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        FreeListAllocator* allocator = nullptr;
+        SliceRegionProvider provider;
+    };
+
+    FreeListAllocator::PlacementPolicy m_pPolicy;
+    std::size_t m_nShards;
+    std::size_t m_shardSize;
+    void* m_start_ptr = nullptr;
+    Shard* m_shards = nullptr;
+public:
+    /// 'nShards' defaults to the number of CPUs.
+    ShardedAllocator(const std::size_t totalSize, const FreeListAllocator::PlacementPolicy pPolicy, const std::size_t nShards = 0);
+
+    virtual ~ShardedAllocator();
+
+    /// Falls back to the other shards when the calling thread's one is full, nullptr when none has room.
+    virtual void* Allocate(const std::size_t size, const std::size_t alignment = 0) override;
+
+    /// Any thread may free any block.
+    virtual void Free(void* ptr) override;
+
+    /// Resizes the block within its own shard.
+    virtual void* Reallocate(void* ptr, const std::size_t newSize, const std::size_t alignment = 0) override;
+
+    virtual void Init() override;
+
+    virtual std::size_t GetUsed() const override;
+    virtual std::size_t GetPeak() const override;
+
+    std::size_t GetShardCount() const { return m_nShards; }
+    std::size_t ShardOf(const void* ptr) const { return ((std::size_t) ptr - (std::size_t) m_start_ptr) / m_shardSize; }
+private:
+    ShardedAllocator(ShardedAllocator &shardedAllocator);
+
+    /// Locks and returns the shard the calling thread should allocate from.
+    Shard& LockShard();
+    static std::size_t CurrentCpu();
+    void DestroyShards();
+};
+
+#endif /* SHARDEDALLOCATOR_H */
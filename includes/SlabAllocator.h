@@ -0,0 +1,125 @@
+#ifndef SLABALLOCATOR_H
+#define SLABALLOCATOR_H
+
+#include "Allocator.h"
+#include "StackLinkedList.h"
+
+/**
+ * Size classes served by the SlabAllocator: 16 byte steps up to 128 bytes, then
+ * four classes per power of two up to 4096 bytes. A request never wastes more
+ * than a quarter of its chunk.
+ */
+namespace SlabSizeClasses {
+    constexpr std::size_t GRANULE = 16;
+    constexpr std::size_t SMALL_LIMIT = 128;
+    constexpr std::size_t SMALL_CLASSES = SMALL_LIMIT / GRANULE;
+    constexpr std::size_t CLASSES_PER_DOUBLING = 4;
+    constexpr std::size_t MAX_SIZE = 4096;
+    constexpr std::size_t COUNT = 28;
+
+    constexpr std::size_t Log2(std::size_t value) {
+        std::size_t result = 0;
+        while (value > 1) {
+            value >>= 1;
+            ++result;
+        }
+        return result;
+    }
+
+    constexpr std::size_t ClassSize(const std::size_t sizeClass) {
+        if (sizeClass < SMALL_CLASSES) {
+            return (sizeClass + 1) * GRANULE;
+        }
+        const std::size_t base = SMALL_LIMIT << ((sizeClass - SMALL_CLASSES) / CLASSES_PER_DOUBLING);
+        return base + ((sizeClass - SMALL_CLASSES) % CLASSES_PER_DOUBLING + 1) * (base / CLASSES_PER_DOUBLING);
+    }
+
+    constexpr std::size_t ComputeClass(const std::size_t size) {
+        if (size <= SMALL_LIMIT) {
+            return size == 0 ? 0 : (size - 1) / GRANULE;
+        }
+        const std::size_t exponent = Log2(size - 1);
+        const std::size_t step = (std::size_t) 1 << (exponent - 2);
+        return SMALL_CLASSES + (exponent - Log2(SMALL_LIMIT)) * CLASSES_PER_DOUBLING + (size - 1 - ((std::size_t) 1 << exponent)) / step;
+    }
+
+    // Every size in a GRANULE-wide bucket maps to the same class, so one byte per bucket is enough
+    struct Table {
+        unsigned char classes[MAX_SIZE / GRANULE + 1];
+
+        constexpr Table() : classes{} {
+            for (std::size_t i = 0; i <= MAX_SIZE / GRANULE; ++i) {
+                classes[i] = (unsigned char) ComputeClass(i * GRANULE);
+            }
+        }
+    };
+
+    constexpr Table TABLE{};
+
+    constexpr std::size_t SizeToClass(const std::size_t size) {
+        return TABLE.classes[(size + GRANULE - 1) / GRANULE];
+    }
+
+    static_assert(ClassSize(COUNT - 1) == MAX_SIZE, "Last size class must serve MAX_SIZE");
+    static_assert(SizeToClass(MAX_SIZE) == COUNT - 1, "Size class table is inconsistent");
+}
+
+/**
+ * @brief Segregated-fit allocator made of pool-style spans.
+ *
+ * The region is cut into SPAN_SIZE spans. A span is dedicated to one size
+ * class on first use and hands out chunks from an intrusive free list, exactly
+ * like a PoolAllocator, falling back to a bump offset for chunks never used
+ * before (so Init() does not touch the whole region). Span metadata lives in
+ * a side table indexed by address, which makes Free() O(1) without headers.
+ */
+class SlabAllocator : public Allocator {
+public:
+    static constexpr std::size_t SPAN_SIZE = 65536;
+
+private:
+    struct FreeHeader {
+    };
+    using Node = StackLinkedList<FreeHeader>::Node;
+
+    struct Span {
+        Span* previous;
+        Span* next;
+        StackLinkedList<FreeHeader> freeList;
+        std::size_t sizeClass;
+        std::size_t allocated;
+        std::size_t bumpOffset;
+    };
+
+    void* m_start_ptr = nullptr;
+    Span* m_spans = nullptr;
+    std::size_t m_nSpans;
+    std::size_t m_nextSpan;
+    Span* m_freeSpans;
+    Span* m_partialSpans[SlabSizeClasses::COUNT];
+
+public:
+    SlabAllocator(const std::size_t totalSize);
+
+    virtual ~SlabAllocator();
+
+    virtual void* Allocate(const std::size_t size, const std::size_t alignment = 0) override;
+
+    virtual void Free(void* ptr) override;
+
+    virtual void Init() override;
+
+    virtual void Reset();
+private:
+    SlabAllocator(SlabAllocator &slabAllocator);
+
+    Span* AcquireSpan(const std::size_t sizeClass);
+    void ReleaseSpan(Span* span);
+
+    void LinkPartial(Span* span);
+    void UnlinkPartial(Span* span);
+
+    static std::size_t AlignedClass(const std::size_t size, const std::size_t alignment);
+};
+
+#endif /* SLABALLOCATOR_H */
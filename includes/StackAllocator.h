@@ -2,12 +2,21 @@
 #define STACKALLOCATOR_H
 
 #include "Allocator.h"
+#include "VirtualArena.h"
 
 class StackAllocator : public Allocator {
 protected:
     void* m_start_ptr = nullptr;
     std::size_t m_offset;
+    VirtualArena m_arena;
+    bool m_reserve = false;
+    std::size_t m_retainedSize;
+    // The only allocation Reallocate() can resize in place, nullptr once the stack was popped
+    void* m_lastAllocation = nullptr;
 public:
+    // Offset to rewind to, everything allocated after it is released by FreeToMarker()
+    typedef std::size_t Marker;
+
     StackAllocator(const std::size_t totalSize);
 
     virtual ~StackAllocator();
@@ -16,9 +25,30 @@ public:
 
     virtual void Free(void* ptr);
 
+    /// Pops the top allocation without reading a header, so it also frees AllocateHeaderless() blocks. The
+    /// alignment padding below the block stays allocated until the allocation under it is freed.
+    virtual void FreeSized(void* ptr, const std::size_t size) override;
+
+    /// Resizes the top allocation in place by moving the offset. Any other block is copied to a new allocation on
+    /// top of the stack, its space is reclaimed when the stack is popped below it.
+    virtual void* Reallocate(void* ptr, const std::size_t newSize, const std::size_t alignment = 0) override;
+
     virtual void Init() override;
 
     virtual void Reset();
+
+    /// Must be called before Init(). The region is then only reserved and committed as the offset grows, Reset()
+    /// decommits everything above retainedSize.
+    void SetReserveMode(const std::size_t retainedSize);
+
+    Marker GetMarker() const { return m_offset; }
+
+    /// Releases every allocation made since the marker was taken in O(1), whatever their number.
+    void FreeToMarker(const Marker marker);
+
+    /// Allocation without the AllocationHeader, it cannot be passed to Free() and is only released by
+    /// FreeSized(), FreeToMarker() or Reset().
+    void* AllocateHeaderless(const std::size_t size, const std::size_t alignment = 0);
     
     std::size_t GetOffset() const { return m_offset; }
     void* GetStartPtr() const { return m_start_ptr; }
@@ -0,0 +1,44 @@
+#ifndef STATICALLOCATOR_H
+#define STATICALLOCATOR_H
+
+#include "AllocatorPolicies.h"
+#include <cstddef> // size_t
+
+/**
+ * @brief Allocator assembled from compile-time policies, the counterpart of the virtual Allocator hierarchy.
+ *
+ * Nothing is virtual and the alignment is a template constant, so Allocate()
+ * and Free() inline into the caller and a NoLock or NoStats policy compiles to
+ * nothing. Blocks are freed with their size, as sized delete does, so that the
+ * statistics need no header.
+ *
+ *     StaticAllocator<PoolStorage<64>, 16, MutexLock, TrackStats> pool(1 << 20);
+ *     StaticAllocator<FreeListStorage<FreeListAllocator::FIND_BEST>> freeList(1 << 20);
+ */
+template <class StoragePolicy, std::size_t Alignment = 8, class LockPolicy = NoLock, class StatsPolicy = NoStats>
+class StaticAllocator {
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+private:
+    StoragePolicy m_storage;
+    LockPolicy m_lock;
+    StatsPolicy m_stats;
+public:
+    StaticAllocator(const std::size_t totalSize);
+
+    void Init();
+
+    void* Allocate(const std::size_t size);
+
+    void Free(void* ptr, const std::size_t size);
+
+    void Reset();
+
+    std::size_t GetUsed() const { return m_stats.GetUsed(); }
+    std::size_t GetPeak() const { return m_stats.GetPeak(); }
+private:
+    StaticAllocator(StaticAllocator &staticAllocator);
+};
+
+#include "StaticAllocatorImpl.h"
+
+#endif /* STATICALLOCATOR_H */
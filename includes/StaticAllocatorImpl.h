@@ -0,0 +1,38 @@
+#include "StaticAllocator.h"
+#include <mutex>  /* lock_guard */
+
+template <class StoragePolicy, std::size_t Alignment, class LockPolicy, class StatsPolicy>
+StaticAllocator<StoragePolicy, Alignment, LockPolicy, StatsPolicy>::StaticAllocator(const std::size_t totalSize)
+: m_storage(totalSize) {
+}
+
+template <class StoragePolicy, std::size_t Alignment, class LockPolicy, class StatsPolicy>
+void StaticAllocator<StoragePolicy, Alignment, LockPolicy, StatsPolicy>::Init() {
+    std::lock_guard<LockPolicy> lock(m_lock);
+    m_storage.Init(Alignment);
+    m_stats.Reset();
+}
+
+template <class StoragePolicy, std::size_t Alignment, class LockPolicy, class StatsPolicy>
+inline void* StaticAllocator<StoragePolicy, Alignment, LockPolicy, StatsPolicy>::Allocate(const std::size_t size) {
+    std::lock_guard<LockPolicy> lock(m_lock);
+    void* ptr = m_storage.Allocate(size, Alignment);
+    if (ptr != nullptr) {
+        m_stats.OnAllocate(size);
+    }
+    return ptr;
+}
+
+template <class StoragePolicy, std::size_t Alignment, class LockPolicy, class StatsPolicy>
+inline void StaticAllocator<StoragePolicy, Alignment, LockPolicy, StatsPolicy>::Free(void* ptr, const std::size_t size) {
+    std::lock_guard<LockPolicy> lock(m_lock);
+    m_storage.Free(ptr, size);
+    m_stats.OnFree(size);
+}
+
+template <class StoragePolicy, std::size_t Alignment, class LockPolicy, class StatsPolicy>
+void StaticAllocator<StoragePolicy, Alignment, LockPolicy, StatsPolicy>::Reset() {
+    std::lock_guard<LockPolicy> lock(m_lock);
+    m_storage.Reset();
+    m_stats.Reset();
+}
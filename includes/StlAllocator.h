@@ -0,0 +1,46 @@
+#ifndef STLALLOCATOR_H
+#define STLALLOCATOR_H
+
+#include "Allocator.h"
+#include <cstddef> // size_t
+#include <type_traits> // true_type
+
+/**
+ * @brief Allocator-traits compatible adapter around any Allocator.
+ *
+ * Unlike AllocatorResource it is bound at compile time, e.g.
+ * std::vector<int, StlAllocator<int>> v(StlAllocator<int>(&freeList)).
+ * deallocate() forwards the size of the allocation through FreeSized().
+ */
+template <class T>
+class StlAllocator {
+public:
+    typedef T value_type;
+
+    // Containers of a moved or swapped container keep using the same allocator
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    explicit StlAllocator(Allocator* allocator) noexcept;
+
+    template <class U>
+    StlAllocator(const StlAllocator<U>& other) noexcept;
+
+    T* allocate(const std::size_t n);
+
+    void deallocate(T* ptr, const std::size_t n) noexcept;
+
+    Allocator* GetAllocator() const noexcept { return m_allocator; }
+private:
+    Allocator* m_allocator;
+};
+
+template <class T, class U>
+bool operator==(const StlAllocator<T>& a, const StlAllocator<U>& b) noexcept { return a.GetAllocator() == b.GetAllocator(); }
+
+template <class T, class U>
+bool operator!=(const StlAllocator<T>& a, const StlAllocator<U>& b) noexcept { return !(a == b); }
+
+#include "StlAllocatorImpl.h"
+
+#endif /* STLALLOCATOR_H */
@@ -0,0 +1,30 @@
+#include "StlAllocator.h"
+#include <new>  /* bad_alloc */
+
+template <class T>
+StlAllocator<T>::StlAllocator(Allocator* allocator) noexcept
+: m_allocator(allocator) {
+}
+
+template <class T>
+template <class U>
+StlAllocator<T>::StlAllocator(const StlAllocator<U>& other) noexcept
+: m_allocator(other.GetAllocator()) {
+}
+
+template <class T>
+T* StlAllocator<T>::allocate(const std::size_t n) {
+    // Same minimum alignment as AllocatorResource
+    void* ptr = m_allocator->Allocate(n * sizeof(T), alignof(T) > alignof(void*) ? alignof(T) : alignof(void*));
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return static_cast<T*>(ptr);
+}
+
+template <class T>
+void StlAllocator<T>::deallocate(T* ptr, const std::size_t n) noexcept {
+    if (m_allocator->SupportsFree()) {
+        m_allocator->FreeSized(ptr, n * sizeof(T));
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef TLSFALLOCATOR_H
+#define TLSFALLOCATOR_H
+
+#include "Allocator.h"
+#include <cstdint> // uint32_t, uint64_t
+
+/**
+ * @brief Two-Level Segregated Fit allocator.
+ *
+ * Free blocks are kept in segregated lists indexed by two levels: the first
+ * level splits sizes by power of two and the second level splits every power
+ * of two into SL_INDEX_COUNT linear ranges. A bitmap per level tells which
+ * lists are non-empty, so finding a suitable block is a couple of bit scans
+ * and Allocate/Free are O(1) regardless of how fragmented the heap is.
+ * Every block knows its physical predecessor, which lets Free() coalesce
+ * immediately with both neighbours.
+ */
+class TLSFAllocator : public Allocator {
+public:
+    static const std::size_t ALIGN_SIZE_LOG2 = 4;
+    static const std::size_t ALIGN_SIZE = 1 << ALIGN_SIZE_LOG2;
+    static const std::size_t SL_INDEX_COUNT_LOG2 = 4;
+    static const std::size_t SL_INDEX_COUNT = 1 << SL_INDEX_COUNT_LOG2;
+    static const std::size_t FL_INDEX_MAX = 40;
+    static const std::size_t FL_INDEX_SHIFT = SL_INDEX_COUNT_LOG2 + ALIGN_SIZE_LOG2;
+    static const std::size_t FL_INDEX_COUNT = FL_INDEX_MAX - FL_INDEX_SHIFT + 1;
+    static const std::size_t SMALL_BLOCK_SIZE = 1 << FL_INDEX_SHIFT;
+
+private:
+    struct BlockHeader {
+        // Always valid, the first block points to nullptr
+        BlockHeader* previousPhysical;
+        // Size of the payload, the lowest bit marks a free block
+        std::size_t size;
+        // Only stored in free blocks, they overlap the payload
+        BlockHeader* nextFree;
+        BlockHeader* previousFree;
+    };
+
+    static const std::size_t FREE_BIT = 1;
+    static const std::size_t BLOCK_HEADER_SIZE = 2 * sizeof(void*);
+    static const std::size_t MIN_BLOCK_SIZE = sizeof(BlockHeader) - BLOCK_HEADER_SIZE;
+
+    void* m_start_ptr = nullptr;
+    uint64_t m_flBitmap;
+    uint32_t m_slBitmap[FL_INDEX_COUNT];
+    BlockHeader* m_blocks[FL_INDEX_COUNT][SL_INDEX_COUNT];
+
+public:
+    TLSFAllocator(const std::size_t totalSize);
+
+    virtual ~TLSFAllocator();
+
+    virtual void* Allocate(const std::size_t size, const std::size_t alignment = 0) override;
+
+    virtual void Free(void* ptr) override;
+
+    virtual void Init() override;
+
+    virtual void Reset();
+private:
+    TLSFAllocator(TLSFAllocator &tlsfAllocator);
+
+    static void MappingInsert(const std::size_t size, std::size_t& fl, std::size_t& sl);
+    static void MappingSearch(const std::size_t size, std::size_t& fl, std::size_t& sl);
+
+    BlockHeader* FindSuitable(std::size_t& fl, std::size_t& sl) const;
+    void InsertFree(BlockHeader* block);
+    void RemoveFree(BlockHeader* block);
+
+    BlockHeader* Split(BlockHeader* block, const std::size_t size);
+    BlockHeader* Merge(BlockHeader* previous, BlockHeader* block);
+
+    static std::size_t BlockSize(const BlockHeader* block) { return block->size & ~FREE_BIT; }
+    static bool IsFree(const BlockHeader* block) { return (block->size & FREE_BIT) != 0; }
+    static BlockHeader* NextPhysical(const BlockHeader* block) { return (BlockHeader*) ((std::size_t) block + BLOCK_HEADER_SIZE + BlockSize(block)); }
+};
+
+#endif /* TLSFALLOCATOR_H */
@@ -0,0 +1,96 @@
+#ifndef THREADCACHEALLOCATOR_H
+#define THREADCACHEALLOCATOR_H
+
+#include "Allocator.h"
+#include "PoolAllocator.h"
+#include "FreeListAllocator.h"
+#include <mutex>
+
+/**
+ * @brief Thread-caching front end over a central heap of pools.
+ *
+ * Requests up to MAX_SMALL_SIZE bytes are rounded up to a power-of-two size
+ * class. Every thread owns one magazine (a small array of free chunks) per
+ * class, so the common Allocate/Free path only touches the calling thread's
+ * cache. Empty magazines are refilled, and full ones drained, in batches of
+ * BATCH_SIZE chunks from a PoolAllocator per class that is guarded by its own
+ * mutex. Bigger or over-aligned requests go to a locked FreeListAllocator.
+ * Threads past the first maxThreads live ones have no cache and take one
+ * chunk at a time from the central pools.
+ *
+ * m_used and m_peak count the bytes handed out by the central heap, which
+ * includes chunks parked in thread caches.
+ */
+class ThreadCacheAllocator : public Allocator {
+public:
+    static const std::size_t MIN_SMALL_SIZE = 16;
+    static const std::size_t MAX_SMALL_SIZE = 4096;
+    static const std::size_t SIZE_CLASSES = 9;
+    static const std::size_t MAGAZINE_CAPACITY = 64;
+    static const std::size_t BATCH_SIZE = MAGAZINE_CAPACITY / 2;
+
+private:
+    struct Magazine {
+        std::size_t count;
+        void* chunks[MAGAZINE_CAPACITY];
+    };
+    struct ThreadCache {
+        // Keeps the magazines of two threads on different cache lines
+        char padding[64];
+        Magazine magazines[SIZE_CLASSES];
+    };
+    struct CentralClass {
+        std::mutex mutex;
+        PoolAllocator* pool;
+    };
+
+    std::size_t m_maxThreads;
+    std::size_t m_classPoolSize;
+    ThreadCache* m_caches = nullptr;
+    CentralClass m_classes[SIZE_CLASSES];
+
+    std::mutex m_largeMutex;
+    FreeListAllocator* m_largeHeap = nullptr;
+
+    std::mutex m_statsMutex;
+
+public:
+    ThreadCacheAllocator(const std::size_t totalSize, const std::size_t maxThreads = 64);
+
+    virtual ~ThreadCacheAllocator();
+
+    virtual void* Allocate(const std::size_t size, const std::size_t alignment = 0) override;
+
+    virtual void Free(void* ptr) override;
+
+    virtual void Init() override;
+
+    /// Returns every cached chunk to the central heap. Must not race with other threads.
+    virtual void Reset();
+
+    /// Drains the calling thread's magazines back to the central heap.
+    void Flush();
+
+    /// Takes every internal lock, e.g. around fork() so that the child does not inherit a lock held by another thread.
+    void LockAll();
+    void UnlockAll();
+
+private:
+    ThreadCacheAllocator(ThreadCacheAllocator &threadCacheAllocator);
+
+    void Refill(const std::size_t sizeClass, Magazine& magazine);
+    void Drain(const std::size_t sizeClass, Magazine& magazine, const std::size_t count);
+    void* AllocateUncached(const std::size_t sizeClass);
+    void FreeUncached(const std::size_t sizeClass, void* ptr);
+
+    void UpdateUsed(const std::size_t allocated, const std::size_t freed);
+    void DestroyHeaps();
+
+    std::size_t FindClass(const void* ptr) const;
+    static std::size_t SizeClass(const std::size_t size);
+    static std::size_t ClassSize(const std::size_t sizeClass) { return MIN_SMALL_SIZE << sizeClass; }
+    // nullptr when the calling thread is past the first m_maxThreads ones
+    ThreadCache* CurrentCache() const;
+};
+
+#endif /* THREADCACHEALLOCATOR_H */
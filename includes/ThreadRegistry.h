@@ -0,0 +1,24 @@
+#ifndef THREADREGISTRY_H
+#define THREADREGISTRY_H
+
+#include <cstddef> // size_t
+
+/**
+ * @brief Process-wide numbering of the live threads, used to index per-thread state.
+ *
+ * A thread gets its index the first time it asks for it. The index of an
+ * exited thread is handed to the next new thread, which then simply inherits
+ * whatever the previous owner left in that slot.
+ */
+class ThreadRegistry {
+public:
+    static std::size_t CurrentIndex();
+
+    /// Keeps threads from registering or exiting, e.g. around fork().
+    static void Lock();
+    static void Unlock();
+private:
+    ThreadRegistry() = delete;
+};
+
+#endif /* THREADREGISTRY_H */
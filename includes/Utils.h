@@ -47,6 +47,18 @@ public:
 
 		return padding;
 	}
+
+	/// Returns the index of the least significant set bit. The value must not be zero.
+	static std::size_t FindFirstSet(const std::size_t value)
+	{
+		return (std::size_t) __builtin_ctzll((unsigned long long) value);
+	}
+
+	/// Returns the index of the most significant set bit. The value must not be zero.
+	static std::size_t FindLastSet(const std::size_t value)
+	{
+		return (std::size_t) (63 - __builtin_clzll((unsigned long long) value));
+	}
 };
 
 #endif /* UTILS_H */
\ No newline at end of file
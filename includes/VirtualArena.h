@@ -0,0 +1,49 @@
+#ifndef VIRTUALARENA_H
+#define VIRTUALARENA_H
+
+#include "RegionProvider.h"
+
+/**
+ * @brief Contiguous region for bump-style allocators, optionally committed on demand.
+ *
+ * In reserved mode the whole size is only reserved as address space. The owner
+ * calls EnsureCommitted() with the end of what it is about to hand out, which
+ * is a single compare unless the committed part has to grow, and Trim() when it
+ * rewinds, which decommits everything above the retained size so the resident
+ * memory does not stick at the worst case ever seen.
+ */
+class VirtualArena {
+private:
+    RegionProvider* m_provider = nullptr;
+    void* m_start_ptr = nullptr;
+    std::size_t m_size = 0;
+    std::size_t m_committed = 0;
+    std::size_t m_retainedSize = 0;
+    bool m_reserved = false;
+
+public:
+    VirtualArena() = default;
+
+    ~VirtualArena();
+
+    /// Gets a fully committed region, Trim() does nothing.
+    void Allocate(RegionProvider* provider, const std::size_t size);
+
+    /// Reserves the region, Trim() keeps the first 'retainedSize' bytes committed.
+    void Reserve(RegionProvider* provider, const std::size_t size, const std::size_t retainedSize);
+
+    void Release();
+
+    bool EnsureCommitted(const std::size_t end) { return end <= m_committed || Commit(end); }
+
+    void Trim();
+
+    void* GetStartPtr() const { return m_start_ptr; }
+    std::size_t GetCommitted() const { return m_committed; }
+private:
+    VirtualArena(VirtualArena &virtualArena);
+
+    bool Commit(const std::size_t end);
+};
+
+#endif /* VIRTUALARENA_H */
@@ -1,2 +1,22 @@
 #include "Allocator.h"
-#include <cassert> //assert
\ No newline at end of file
+#include <cassert> //assert
+
+void *Allocator::Reallocate(void *ptr, const std::size_t newSize, const std::size_t alignment) {
+    return ptr == nullptr ? Allocate(newSize, alignment) : nullptr;
+}
+
+std::size_t Allocator::AllocateBatch(const std::size_t size, const std::size_t count, void **out, const std::size_t alignment) {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = Allocate(size, alignment);
+        if (out[i] == nullptr) {
+            return i;
+        }
+    }
+    return count;
+}
+
+void Allocator::FreeBatch(void **ptrs, const std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        Free(ptrs[i]);
+    }
+}
@@ -0,0 +1,28 @@
+#include "AllocatorResource.h"
+#include <new>  /* bad_alloc */
+#include <algorithm>    /* max */
+
+AllocatorResource::AllocatorResource(Allocator* allocator)
+: m_allocator{allocator} {
+}
+
+void* AllocatorResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    // Some allocators cannot align below a pointer (FreeListAllocator needs room for its header)
+    void* ptr = m_allocator->Allocate(bytes, std::max(alignment, alignof(void*)));
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void AllocatorResource::do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) {
+    if (m_allocator->SupportsFree()) {
+        m_allocator->FreeSized(ptr, bytes);
+    }
+}
+
+bool AllocatorResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    // Two resources can free each other's memory when they share the allocator
+    const AllocatorResource* resource = dynamic_cast<const AllocatorResource*>(&other);
+    return resource != nullptr && resource->m_allocator == m_allocator;
+}
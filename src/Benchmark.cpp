@@ -1,8 +1,18 @@
 #include "Benchmark.h"
 #include <iostream>
+#include <algorithm>  /* min */
 #include <stdlib.h>     /* srand, rand */
 #include <cassert>
 #include <memory>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include "AllocatorResource.h"
 
 void Benchmark::SingleAllocation(std::unique_ptr<Allocator>& allocator, const std::size_t size, const std::size_t alignment) {
     std::cout << "BENCHMARK: ALLOCATION" << IO::endl;
@@ -22,7 +32,7 @@ void Benchmark::SingleAllocation(std::unique_ptr<Allocator>& allocator, const st
     
     FinishRound();
 
-    BenchmarkResults results = buildResults(m_nOperations, std::move(TimeElapsed), allocator->m_peak);
+    BenchmarkResults results = buildResults(m_nOperations, std::move(TimeElapsed), allocator->GetPeak());
 
     PrintResults(results);
 }
@@ -51,11 +61,134 @@ void Benchmark::SingleFree(std::unique_ptr<Allocator>& allocator, const std::siz
 
     FinishRound();
 
-    BenchmarkResults results = buildResults(m_nOperations, std::move(TimeElapsed), allocator->m_peak);
+    BenchmarkResults results = buildResults(m_nOperations, std::move(TimeElapsed), allocator->GetPeak());
 
     PrintResults(results);
 }
 
+void Benchmark::BatchAllocation(std::unique_ptr<Allocator>& allocator, const std::size_t size, const std::size_t alignment, const std::size_t batchSize) {
+    std::cout << "BENCHMARK: BATCH ALLOCATION" << IO::endl;
+    std::cout << "\tSize:     \t" << size << IO::endl;
+    std::cout << "\tAlignment\t" << alignment << IO::endl;
+    std::cout << "\tBatch:    \t" << batchSize << IO::endl;
+
+    std::vector<void*> addresses(batchSize);
+
+    StartRound();
+
+    allocator->Init();
+
+    std::size_t operations = 0;
+
+    while (operations < m_nOperations) {
+        const std::size_t count = std::min(batchSize, m_nOperations - operations);
+        if (allocator->AllocateBatch(size, count, addresses.data(), alignment) < count) {
+            break;
+        }
+        operations += count;
+    }
+
+    FinishRound();
+
+    BenchmarkResults results = buildResults(operations, std::move(TimeElapsed), allocator->GetPeak());
+
+    PrintResults(results);
+}
+
+void Benchmark::BatchFree(std::unique_ptr<Allocator>& allocator, const std::size_t size, const std::size_t alignment, const std::size_t batchSize) {
+    std::cout << "BENCHMARK: BATCH ALLOCATION/FREE" << IO::endl;
+    std::cout << "\tSize:     \t" << size << IO::endl;
+    std::cout << "\tAlignment\t" << alignment << IO::endl;
+    std::cout << "\tBatch:    \t" << batchSize << IO::endl;
+
+    std::vector<void*> addresses(m_nOperations);
+
+    StartRound();
+
+    allocator->Init();
+
+    std::size_t operations = 0;
+
+    while (operations < m_nOperations) {
+        const std::size_t count = std::min(batchSize, m_nOperations - operations);
+        const std::size_t allocated = allocator->AllocateBatch(size, count, addresses.data() + operations, alignment);
+        operations += allocated;
+        if (allocated < count) {
+            break;
+        }
+    }
+
+    // Released in the same batches, newest first
+    for (std::size_t end = operations; end > 0; ) {
+        const std::size_t count = std::min(batchSize, end);
+        end -= count;
+        allocator->FreeBatch(addresses.data() + end, count);
+    }
+
+    FinishRound();
+
+    BenchmarkResults results = buildResults(operations, std::move(TimeElapsed), allocator->GetPeak());
+
+    PrintResults(results);
+}
+
+void Benchmark::Reallocation(std::unique_ptr<Allocator>& allocator, const std::size_t step, const std::size_t maxSize) {
+    std::cout << "BENCHMARK: REALLOCATION" << IO::endl;
+    std::cout << "\tStep:     \t" << step << IO::endl;
+    std::cout << "\tMax size: \t" << maxSize << IO::endl;
+
+    StartRound();
+
+    allocator->Init();
+
+    std::size_t operations = 0;
+
+    for (auto round = 0u; round < m_nOperations; ++round) {
+        void* buffer = allocator->Allocate(step, 8);
+        ++operations;
+        for (std::size_t size = 2 * step; size <= maxSize && buffer != nullptr; size += step) {
+            buffer = allocator->Reallocate(buffer, size, 8);
+            ++operations;
+        }
+        if (buffer != nullptr && allocator->SupportsFree()) {
+            allocator->Free(buffer);
+        }
+    }
+
+    FinishRound();
+
+    BenchmarkResults results = buildResults(operations, std::move(TimeElapsed), allocator->GetPeak());
+
+    PrintResults(results);
+}
+
+void Benchmark::SmallObjects(std::unique_ptr<Allocator>& allocator, const std::size_t size, const std::size_t nObjects) {
+    std::cout << "BENCHMARK: SMALL OBJECTS" << IO::endl;
+    std::cout << "\tSize:     \t" << size << IO::endl;
+    std::cout << "\tObjects:  \t" << nObjects << IO::endl;
+
+    std::vector<void*> addresses(nObjects);
+
+    StartRound();
+
+    allocator->Init();
+
+    for (std::size_t i = 0; i < nObjects; ++i) {
+        addresses[i] = allocator->Allocate(size, 8);
+    }
+    for (std::size_t i = nObjects; i > 0; --i) {
+        allocator->FreeSized(addresses[i - 1], size);
+    }
+
+    FinishRound();
+
+    BenchmarkResults results = buildResults(2 * nObjects, std::move(TimeElapsed), allocator->GetPeak());
+
+    PrintResults(results);
+    std::cout << "\t\tBytes per object:\t" << static_cast<double>(results.MemoryPeak) / nObjects << IO::endl;
+    std::cout << IO::endl;
+}
+
 void Benchmark::MultipleAllocation(std::unique_ptr<Allocator>& allocator, const std::vector<std::size_t>& allocationSizes, const std::vector<std::size_t>& alignments) {
     assert(allocationSizes.size() == alignments.size() && "Allocation sizes and Alignments must have same length");
 
@@ -95,7 +228,7 @@ void Benchmark::RandomAllocation(std::unique_ptr<Allocator>& allocator, const st
     
     FinishRound();
 
-    BenchmarkResults results = buildResults(m_nOperations, std::move(TimeElapsed), allocator->m_peak);
+    BenchmarkResults results = buildResults(m_nOperations, std::move(TimeElapsed), allocator->GetPeak());
     
     PrintResults(results);
 }
@@ -129,10 +262,239 @@ void Benchmark::RandomFree(std::unique_ptr<Allocator>& allocator, const std::vec
 
     FinishRound();
 
-    BenchmarkResults results = buildResults(m_nOperations, std::move(TimeElapsed), allocator->m_peak);
+    BenchmarkResults results = buildResults(m_nOperations, std::move(TimeElapsed), allocator->GetPeak());
+
+    PrintResults(results);
+
+}
+
+void Benchmark::RandomChurn(std::unique_ptr<Allocator>& allocator, const std::vector<std::size_t>& allocationSizes, const std::vector<std::size_t>& alignments) {
+
+    srand(1);
+
+    std::cout << "\tBENCHMARK: ALLOCATION/RANDOM FREE" << IO::endl;
+
+    StartRound();
+
+    void* addresses[OPERATIONS];
+
+    std::size_t allocation_size;
+    std::size_t alignment;
+
+    allocator->Init();
+
+    for (auto i = 0u; i < m_nOperations; ++i) {
+        this->RandomAllocationAttr(allocationSizes, alignments, allocation_size, alignment);
+        addresses[i] = allocator->Allocate(allocation_size, alignment);
+    }
+
+    // Freeing out of order leaves free blocks of every size scattered over the heap
+    const std::size_t rounds = 10 * m_nOperations;
+    for (auto round = 0u; round < rounds; ++round) {
+        const std::size_t i = rand() % m_nOperations;
+        allocator->Free(addresses[i]);
+        this->RandomAllocationAttr(allocationSizes, alignments, allocation_size, alignment);
+        addresses[i] = allocator->Allocate(allocation_size, alignment);
+    }
+
+    for (auto i = 0u; i < m_nOperations; ++i) {
+        allocator->Free(addresses[i]);
+    }
+
+    FinishRound();
+
+    BenchmarkResults results = buildResults(m_nOperations + 2 * rounds, std::move(TimeElapsed), allocator->GetPeak());
 
     PrintResults(results);
+}
+
+void Benchmark::MultiThreadedRandomFree(std::unique_ptr<Allocator>& allocator, const std::vector<std::size_t>& allocationSizes, const std::vector<std::size_t>& alignments, const unsigned int nThreads) {
+    std::cout << "\tBENCHMARK: ALLOCATION/FREE" << IO::endl;
+    std::cout << "\tThreads:  \t" << nThreads << IO::endl;
+
+    StartRound();
+
+    allocator->Init();
+
+    Allocator* shared = allocator.get();
+    const std::size_t nOperations = m_nOperations;
+    std::vector<std::thread> threads;
+    for (auto t = 0u; t < nThreads; ++t) {
+        threads.emplace_back([shared, nOperations, t, &allocationSizes, &alignments]() {
+            // rand() is shared state, so each thread draws from its own generator
+            std::minstd_rand generator(t + 1);
+            std::vector<void*> addresses(nOperations);
+
+            for (std::size_t i = 0; i < nOperations; ++i) {
+                const std::size_t r = generator() % allocationSizes.size();
+                addresses[i] = shared->Allocate(allocationSizes[r], alignments[r]);
+            }
+            for (std::size_t i = nOperations; i > 0; --i) {
+                shared->Free(addresses[i - 1]);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    FinishRound();
+
+    BenchmarkResults results = buildResults(m_nOperations * nThreads, std::move(TimeElapsed), allocator->GetPeak());
+
+    PrintResults(results);
+}
+
+void Benchmark::CrossThreadFree(std::unique_ptr<Allocator>& allocator, const std::size_t size, const std::size_t alignment) {
+    std::cout << "\tBENCHMARK: ALLOCATION/REMOTE FREE" << IO::endl;
+    std::cout << "\tSize:     \t" << size << IO::endl;
+
+    const std::size_t rounds = 100;
+    // Bounds the blocks in flight so the producer cannot run the allocator dry
+    const std::size_t maxPending = 4;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::vector<void*>> pending;
+    bool done = false;
+
+    StartRound();
+
+    allocator->Init();
+
+    Allocator* shared = allocator.get();
+    std::thread consumer([shared, &mutex, &changed, &pending, &done]() {
+        for (;;) {
+            std::vector<void*> batch;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&pending, &done]() { return !pending.empty() || done; });
+                if (pending.empty()) {
+                    return;
+                }
+                batch = std::move(pending.front());
+                pending.pop_front();
+            }
+            changed.notify_all();
+            for (void* ptr : batch) {
+                shared->Free(ptr);
+            }
+        }
+    });
+
+    for (std::size_t round = 0; round < rounds; ++round) {
+        std::vector<void*> batch(m_nOperations);
+        for (auto i = 0u; i < m_nOperations; ++i) {
+            batch[i] = shared->Allocate(size, alignment);
+        }
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&pending, maxPending]() { return pending.size() < maxPending; });
+            pending.push_back(std::move(batch));
+        }
+        changed.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    changed.notify_all();
+    consumer.join();
+
+    FinishRound();
+
+    BenchmarkResults results = buildResults(2 * m_nOperations * rounds, std::move(TimeElapsed), allocator->GetPeak());
+
+    PrintResults(results);
+}
+
+void Benchmark::VectorGrowth(std::unique_ptr<Allocator>& allocator) {
+    std::cout << "\tBENCHMARK: VECTOR GROWTH" << IO::endl;
+
+    AllocatorResource adapter(allocator.get());
+    std::pmr::memory_resource* resource = allocator ? &adapter : std::pmr::new_delete_resource();
+    if (allocator) {
+        allocator->Init();
+    }
+
+    StartRound();
+
+    for (auto operations = 0u; operations < m_nOperations; ++operations) {
+        // Grows by reallocation, every step frees the previous buffer
+        std::pmr::vector<int> values(resource);
+        for (int i = 0; i < 10000; ++i) {
+            values.push_back(i);
+        }
+    }
+
+    FinishRound();
+
+    BenchmarkResults results = buildResults(m_nOperations, std::move(TimeElapsed), allocator ? allocator->GetPeak() : 0);
+
+    PrintResults(results);
+}
+
+void Benchmark::NodeMap(std::unique_ptr<Allocator>& allocator) {
+    std::cout << "\tBENCHMARK: NODE MAP" << IO::endl;
+
+    AllocatorResource adapter(allocator.get());
+    std::pmr::memory_resource* resource = allocator ? &adapter : std::pmr::new_delete_resource();
+    if (allocator) {
+        allocator->Init();
+    }
+
+    StartRound();
+
+    for (auto operations = 0u; operations < m_nOperations; ++operations) {
+        // One small node per insertion plus the bucket array
+        std::pmr::unordered_map<int, int> map(resource);
+        for (int i = 0; i < 1000; ++i) {
+            map.emplace(i, i);
+        }
+        for (int i = 0; i < 1000; i += 2) {
+            map.erase(i);
+        }
+    }
+
+    FinishRound();
+
+    BenchmarkResults results = buildResults(m_nOperations, std::move(TimeElapsed), allocator ? allocator->GetPeak() : 0);
+
+    PrintResults(results);
+}
+
+void Benchmark::Strings(std::unique_ptr<Allocator>& allocator) {
+    std::cout << "\tBENCHMARK: STRINGS" << IO::endl;
+
+    AllocatorResource adapter(allocator.get());
+    std::pmr::memory_resource* resource = allocator ? &adapter : std::pmr::new_delete_resource();
+    if (allocator) {
+        allocator->Init();
+    }
+
+    StartRound();
+
+    for (auto operations = 0u; operations < m_nOperations; ++operations) {
+        std::pmr::vector<std::pmr::string> strings(resource);
+        strings.reserve(1000);
+        for (int i = 0; i < 1000; ++i) {
+            // Too long for the small string buffer
+            strings.emplace_back("a string long enough to need the heap ");
+            strings.back() += std::to_string(i);
+        }
+    }
+
+    FinishRound();
+
+    BenchmarkResults results = buildResults(m_nOperations, std::move(TimeElapsed), allocator ? allocator->GetPeak() : 0);
+
+    PrintResults(results);
+}
 
+void Benchmark::Containers(std::unique_ptr<Allocator>& allocator) {
+    VectorGrowth(allocator);
+    NodeMap(allocator);
+    Strings(allocator);
 }
 
 void Benchmark::PrintResults(const BenchmarkResults& results) const {
@@ -0,0 +1,198 @@
+#include "BitmapPoolAllocator.h"
+#include <assert.h>
+#include <algorithm>    //max, min
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>  //_mm256_*
+#define HAVE_AVX2_SCAN
+#endif
+#ifdef _DEBUG
+#include <iostream>
+#endif
+
+#ifdef HAVE_AVX2_SCAN
+// Built for AVX2 whatever the compiler flags are, only called after checking for AVX2
+__attribute__((target("avx2")))
+static std::size_t FindNonZeroWordAvx2(const uint64_t* words, std::size_t word, const std::size_t nWords) {
+    for (; word + 4 <= nWords; word += 4) {
+        const __m256i block = _mm256_loadu_si256((const __m256i*) (words + word));
+        if (!_mm256_testz_si256(block, block)) {
+            break;
+        }
+    }
+    while (word < nWords && words[word] == 0) {
+        ++word;
+    }
+    return word;
+}
+#endif
+
+BitmapPoolAllocator::BitmapPoolAllocator(const std::size_t totalSize, const std::size_t chunkSize)
+: Allocator(totalSize), m_chunkSize{chunkSize} {
+    assert(chunkSize > 0 && "Chunk size must not be zero");
+    assert(totalSize % chunkSize == 0 && "Total Size must be a multiple of Chunk Size");
+    m_nChunks = totalSize / chunkSize;
+    m_nWords = (m_nChunks + 63) / 64;
+    m_firstFreeWord = 0;
+#ifdef HAVE_AVX2_SCAN
+    m_useAvx2 = __builtin_cpu_supports("avx2");
+#else
+    m_useAvx2 = false;
+#endif
+}
+
+void BitmapPoolAllocator::Init() {
+    if (m_start_ptr != nullptr) {
+        m_regionProvider->Free(m_start_ptr, m_totalSize);
+        m_start_ptr = nullptr;
+    }
+    m_start_ptr = m_regionProvider->Allocate(m_totalSize);
+    delete[] m_freeMap;
+    m_freeMap = new uint64_t[m_nWords];
+    this->Reset();
+}
+
+BitmapPoolAllocator::~BitmapPoolAllocator() {
+    m_regionProvider->Free(m_start_ptr, m_totalSize);
+    delete[] m_freeMap;
+}
+
+void* BitmapPoolAllocator::Allocate(const std::size_t allocationSize, const std::size_t alignment) {
+    assert(allocationSize <= this->m_chunkSize && "Allocation size must not be bigger than the chunk size");
+
+    const std::size_t word = FindFreeWord(m_firstFreeWord);
+    m_firstFreeWord = word;
+    if (word == m_nWords) {
+        // The pool is full
+        return nullptr;
+    }
+
+    const std::size_t bit = __builtin_ctzll(m_freeMap[word]);
+    m_freeMap[word] &= m_freeMap[word] - 1;
+    void* chunk = ChunkAt(word * 64 + bit);
+
+    m_used += m_chunkSize;
+    m_peak = std::max(m_peak, m_used);
+#ifdef _DEBUG
+    std::cout << "A" << "\t@S " << m_start_ptr << "\t@R " << chunk << "\tM " << m_used << std::endl;
+#endif
+
+    return chunk;
+}
+
+std::size_t BitmapPoolAllocator::AllocateBatch(const std::size_t allocationSize, const std::size_t count, void** out, const std::size_t alignment) {
+    assert(allocationSize <= this->m_chunkSize && "Allocation size must not be bigger than the chunk size");
+
+    std::size_t allocated = 0;
+    std::size_t word = m_firstFreeWord;
+    while (allocated < count) {
+        word = FindFreeWord(word);
+        if (word == m_nWords) {
+            break;
+        }
+        uint64_t free = m_freeMap[word];
+        while (free != 0 && allocated < count) {
+            out[allocated++] = ChunkAt(word * 64 + __builtin_ctzll(free));
+            free &= free - 1;
+        }
+        m_freeMap[word] = free;
+    }
+    m_firstFreeWord = word;
+
+    m_used += allocated * m_chunkSize;
+    m_peak = std::max(m_peak, m_used);
+#ifdef _DEBUG
+    std::cout << "AB" << "\t@S " << m_start_ptr << "\tN " << allocated << "\tM " << m_used << std::endl;
+#endif
+    return allocated;
+}
+
+void BitmapPoolAllocator::Free(void* ptr) {
+    assert(IsAllocated(ptr) && "Chunk is not allocated");
+    const std::size_t chunk = ChunkOf(ptr);
+    m_freeMap[chunk / 64] |= (uint64_t) 1 << (chunk % 64);
+    m_firstFreeWord = std::min(m_firstFreeWord, chunk / 64);
+    m_used -= m_chunkSize;
+
+#ifdef _DEBUG
+    std::cout << "F" << "\t@S " << m_start_ptr << "\t@F " << ptr << "\tM " << m_used << std::endl;
+#endif
+}
+
+void BitmapPoolAllocator::FreeRange(void* ptr, const std::size_t size) {
+    assert((std::size_t) ptr >= (std::size_t) m_start_ptr && (std::size_t) ptr + size <= (std::size_t) m_start_ptr + m_totalSize && "Range is outside the pool");
+    std::size_t chunk = ChunkOf(ptr);
+    assert(ChunkAt(chunk) == ptr && "Range must start at a chunk");
+    const std::size_t end = chunk + (size + m_chunkSize - 1) / m_chunkSize;
+
+    // Whole words at once, partial ones through a mask
+    std::size_t freed = 0;
+    while (chunk < end) {
+        const std::size_t word = chunk / 64;
+        const std::size_t first = chunk % 64;
+        const std::size_t last = std::min<std::size_t>(64, first + (end - chunk));
+        const uint64_t mask = (last == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << last) - 1) & ~(((uint64_t) 1 << first) - 1);
+        freed += __builtin_popcountll(~m_freeMap[word] & mask);
+        m_freeMap[word] |= mask;
+        chunk += last - first;
+    }
+    m_firstFreeWord = std::min(m_firstFreeWord, ChunkOf(ptr) / 64);
+    m_used -= freed * m_chunkSize;
+
+#ifdef _DEBUG
+    std::cout << "FR" << "\t@S " << m_start_ptr << "\t@F " << ptr << "\tN " << freed << "\tM " << m_used << std::endl;
+#endif
+}
+
+std::size_t BitmapPoolAllocator::ReleaseFreePages() {
+    const std::size_t pageSize = m_regionProvider->GetCommitGranularity();
+    const std::size_t start = (std::size_t) m_start_ptr;
+    std::size_t released = 0;
+    for (std::size_t page = (start + pageSize - 1) & ~(pageSize - 1); page + pageSize <= start + m_totalSize; page += pageSize) {
+        // Chunks overlapping the page, a chunk straddling its edges keeps it
+        const std::size_t firstChunk = (page - start) / m_chunkSize;
+        const std::size_t lastChunk = (page + pageSize - 1 - start) / m_chunkSize;
+        bool free = true;
+        for (std::size_t chunk = firstChunk; chunk <= lastChunk && free; ++chunk) {
+            free = (m_freeMap[chunk / 64] >> (chunk % 64)) & 1;
+        }
+        if (free) {
+            // Decommit gives the memory back, Commit makes the range usable again without touching it
+            m_regionProvider->Decommit((void*) page, pageSize);
+            m_regionProvider->Commit((void*) page, pageSize);
+            released += pageSize;
+        }
+    }
+    return released;
+}
+
+void BitmapPoolAllocator::Reset() {
+    m_used = 0;
+    m_peak = 0;
+    for (std::size_t word = 0; word < m_nWords; ++word) {
+        m_freeMap[word] = WordMask(word);
+    }
+    m_firstFreeWord = 0;
+}
+
+bool BitmapPoolAllocator::IsAllocated(const void* ptr) const {
+    const std::size_t chunk = ChunkOf(ptr);
+    return (std::size_t) ptr >= (std::size_t) m_start_ptr && chunk < m_nChunks && ChunkAt(chunk) == ptr
+        && ((m_freeMap[chunk / 64] >> (chunk % 64)) & 1) == 0;
+}
+
+std::size_t BitmapPoolAllocator::FindFreeWord(std::size_t word) const {
+#ifdef HAVE_AVX2_SCAN
+    if (m_useAvx2) {
+        return FindNonZeroWordAvx2(m_freeMap, word, m_nWords);
+    }
+#endif
+    while (word < m_nWords && m_freeMap[word] == 0) {
+        ++word;
+    }
+    return word;
+}
+
+uint64_t BitmapPoolAllocator::WordMask(const std::size_t word) const {
+    const std::size_t valid = m_nChunks - word * 64;
+    return valid >= 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << valid) - 1;
+}
@@ -0,0 +1,127 @@
+#include "ConcurrentPoolAllocator.h"
+#include <cassert>   /* assert */
+#ifdef _DEBUG
+#include <iostream>
+#endif
+
+const uint32_t ConcurrentPoolAllocator::EMPTY;
+
+ConcurrentPoolAllocator::ConcurrentPoolAllocator(const std::size_t totalSize, const std::size_t chunkSize)
+: Allocator(totalSize), m_head{0}, m_allocatedChunks{0}, m_peakChunks{0} {
+    assert(chunkSize > 0 && "Chunk size must be greater than 0");
+    assert(totalSize % chunkSize == 0 && "Total Size must be a multiple of Chunk Size");
+    assert(totalSize / chunkSize < UINT32_MAX && "Too many chunks for 32-bit indices");
+    this->m_chunkSize = chunkSize;
+    this->m_nChunks = totalSize / chunkSize;
+}
+
+void ConcurrentPoolAllocator::Init() {
+    if (m_start_ptr != nullptr) {
+        m_regionProvider->Free(m_start_ptr, m_totalSize);
+        delete[] m_next;
+    }
+    m_start_ptr = m_regionProvider->Allocate(m_totalSize);
+    m_next = new std::atomic<uint32_t>[m_nChunks];
+    this->Reset();
+}
+
+ConcurrentPoolAllocator::~ConcurrentPoolAllocator() {
+    m_regionProvider->Free(m_start_ptr, m_totalSize);
+    m_start_ptr = nullptr;
+    delete[] m_next;
+    m_next = nullptr;
+}
+
+void* ConcurrentPoolAllocator::Allocate(const std::size_t allocationSize, const std::size_t alignment) {
+    assert(allocationSize == this->m_chunkSize && "Allocation size must be equal to chunk size");
+
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    uint32_t index;
+    do {
+        index = HeadIndex(head);
+        if (index == EMPTY) {
+            return nullptr;
+        }
+        // A stale 'next' is harmless: the tag makes the CAS fail if the head moved meanwhile
+    } while (!m_head.compare_exchange_weak(head, MakeHead(head, m_next[index - 1].load(std::memory_order_relaxed)),
+                                           std::memory_order_acquire, std::memory_order_acquire));
+
+    UpdateStatistics(1);
+#ifdef _DEBUG
+    std::cout << "A" << "\t@S " << m_start_ptr << "\t@R " << ToChunk(index) << std::endl;
+#endif
+    return ToChunk(index);
+}
+
+void ConcurrentPoolAllocator::Free(void* ptr) {
+    const uint32_t index = ToIndex(ptr);
+    m_allocatedChunks.fetch_sub(1, std::memory_order_relaxed);
+    PushChain(index, index);
+#ifdef _DEBUG
+    std::cout << "F" << "\t@S " << m_start_ptr << "\t@F " << ptr << std::endl;
+#endif
+}
+
+std::size_t ConcurrentPoolAllocator::AllocateBatch(const std::size_t size, const std::size_t count, void** out, const std::size_t alignment) {
+    assert(size == this->m_chunkSize && "Allocation size must be equal to chunk size");
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    std::size_t popped;
+    uint32_t next;
+    do {
+        // Walk up to 'count' links from the observed head and try to detach them all at once
+        popped = 0;
+        next = HeadIndex(head);
+        while (popped < count && next != EMPTY) {
+            out[popped++] = ToChunk(next);
+            next = m_next[next - 1].load(std::memory_order_relaxed);
+        }
+        if (popped == 0) {
+            return 0;
+        }
+    } while (!m_head.compare_exchange_weak(head, MakeHead(head, next),
+                                           std::memory_order_acquire, std::memory_order_acquire));
+
+    UpdateStatistics(popped);
+    return popped;
+}
+
+void ConcurrentPoolAllocator::FreeBatch(void** ptrs, const std::size_t count) {
+    if (count == 0) {
+        return;
+    }
+    // Link the chunks privately, then publish the whole chain with one CAS
+    for (std::size_t i = 0; i + 1 < count; ++i) {
+        m_next[ToIndex(ptrs[i]) - 1].store(ToIndex(ptrs[i + 1]), std::memory_order_relaxed);
+    }
+    m_allocatedChunks.fetch_sub(count, std::memory_order_relaxed);
+    PushChain(ToIndex(ptrs[0]), ToIndex(ptrs[count - 1]));
+}
+
+void ConcurrentPoolAllocator::PushChain(const uint32_t first, const uint32_t last) {
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    do {
+        m_next[last - 1].store(HeadIndex(head), std::memory_order_relaxed);
+    } while (!m_head.compare_exchange_weak(head, MakeHead(head, first),
+                                           std::memory_order_release, std::memory_order_relaxed));
+}
+
+void ConcurrentPoolAllocator::UpdateStatistics(const std::size_t allocated) {
+    const std::size_t used = m_allocatedChunks.fetch_add(allocated, std::memory_order_relaxed) + allocated;
+    std::size_t peak = m_peakChunks.load(std::memory_order_relaxed);
+    while (used > peak && !m_peakChunks.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {
+    }
+}
+
+void ConcurrentPoolAllocator::Reset() {
+    m_allocatedChunks.store(0, std::memory_order_relaxed);
+    m_peakChunks.store(0, std::memory_order_relaxed);
+    // Chunks are handed out in address order
+    for (std::size_t i = 0; i < m_nChunks; ++i) {
+        m_next[i].store(i + 1 < m_nChunks ? (uint32_t) (i + 2) : EMPTY, std::memory_order_relaxed);
+    }
+    m_head.store(MakeHead(m_head.load(std::memory_order_relaxed), 1), std::memory_order_release);
+}
@@ -0,0 +1,126 @@
+#include "DoubleEndedStackAllocator.h"
+#include <algorithm>    /* max */
+#include <cassert>   /* assert */
+#ifdef _DEBUG
+#include <iostream>
+#endif
+
+DoubleEndedStackAllocator::DoubleEndedStackAllocator(const std::size_t totalSize)
+: Allocator(totalSize) {
+}
+
+void DoubleEndedStackAllocator::Init() {
+    if (m_start_ptr != nullptr) {
+        m_regionProvider->Free(m_start_ptr, m_totalSize);
+    }
+    m_start_ptr = m_regionProvider->Allocate(m_totalSize);
+    this->Reset();
+}
+
+DoubleEndedStackAllocator::~DoubleEndedStackAllocator() {
+    m_regionProvider->Free(m_start_ptr, m_totalSize);
+    m_start_ptr = nullptr;
+}
+
+void* DoubleEndedStackAllocator::Allocate(const std::size_t size, const std::size_t alignment) {
+    return AllocateBottom(size, alignment);
+}
+
+void DoubleEndedStackAllocator::Free(void* ptr) {
+    if ((std::size_t) ptr < (std::size_t) m_start_ptr + m_bottom) {
+        FreeBottom(ptr);
+    } else {
+        FreeTop(ptr);
+    }
+}
+
+void* DoubleEndedStackAllocator::AllocateBottom(const std::size_t size, const std::size_t alignment) {
+    const std::size_t effectiveAlignment = EffectiveAlignment(alignment);
+    const std::size_t currentAddress = (std::size_t) m_start_ptr + m_bottom;
+    // The header sits right below the aligned address
+    const std::size_t nextAddress = (currentAddress + sizeof(AllocationHeader) + effectiveAlignment - 1) & ~(effectiveAlignment - 1);
+
+    if (nextAddress + size > (std::size_t) m_start_ptr + m_top) {
+        return nullptr;
+    }
+
+    AllocationHeader* header = (AllocationHeader*) (nextAddress - sizeof(AllocationHeader));
+    header->previousOffset = m_bottom;
+    m_bottom = nextAddress + size - (std::size_t) m_start_ptr;
+    UpdateUsed();
+
+#ifdef _DEBUG
+    std::cout << "A" << "\t@C " << (void*) currentAddress << "\t@R " << (void*) nextAddress << "\tB " << m_bottom << "\tT " << m_top << std::endl;
+#endif
+    return (void*) nextAddress;
+}
+
+void* DoubleEndedStackAllocator::AllocateTop(const std::size_t size, const std::size_t alignment) {
+    const std::size_t effectiveAlignment = EffectiveAlignment(alignment);
+    const std::size_t currentAddress = (std::size_t) m_start_ptr + m_top;
+    const std::size_t lowest = (std::size_t) m_start_ptr + m_bottom + sizeof(AllocationHeader);
+
+    if (currentAddress < lowest || size > currentAddress - lowest) {
+        return nullptr;
+    }
+    const std::size_t nextAddress = (currentAddress - size) & ~(effectiveAlignment - 1);
+    if (nextAddress < lowest) {
+        return nullptr;
+    }
+
+    AllocationHeader* header = (AllocationHeader*) (nextAddress - sizeof(AllocationHeader));
+    header->previousOffset = m_top;
+    m_top = (std::size_t) header - (std::size_t) m_start_ptr;
+    UpdateUsed();
+
+#ifdef _DEBUG
+    std::cout << "A" << "\t@C " << (void*) currentAddress << "\t@R " << (void*) nextAddress << "\tB " << m_bottom << "\tT " << m_top << std::endl;
+#endif
+    return (void*) nextAddress;
+}
+
+void DoubleEndedStackAllocator::FreeBottom(void* ptr) {
+    const AllocationHeader* header = (const AllocationHeader*) ((std::size_t) ptr - sizeof(AllocationHeader));
+    assert(header->previousOffset < m_bottom && "Only the last allocation of the bottom end can be freed");
+    m_bottom = header->previousOffset;
+    UpdateUsed();
+
+#ifdef _DEBUG
+    std::cout << "F" << "\t@F " << ptr << "\tB " << m_bottom << "\tT " << m_top << std::endl;
+#endif
+}
+
+void DoubleEndedStackAllocator::FreeTop(void* ptr) {
+    const std::size_t headerOffset = (std::size_t) ptr - sizeof(AllocationHeader) - (std::size_t) m_start_ptr;
+    assert(headerOffset == m_top && "Only the last allocation of the top end can be freed");
+    m_top = ((const AllocationHeader*) ((std::size_t) m_start_ptr + headerOffset))->previousOffset;
+    UpdateUsed();
+
+#ifdef _DEBUG
+    std::cout << "F" << "\t@F " << ptr << "\tB " << m_bottom << "\tT " << m_top << std::endl;
+#endif
+}
+
+void DoubleEndedStackAllocator::FreeToBottomMarker(const Marker marker) {
+    assert(marker <= m_bottom && "Marker is above the bottom stack");
+    m_bottom = marker;
+    UpdateUsed();
+}
+
+void DoubleEndedStackAllocator::FreeToTopMarker(const Marker marker) {
+    assert(marker >= m_top && marker <= m_totalSize && "Marker is below the top stack");
+    m_top = marker;
+    UpdateUsed();
+}
+
+void DoubleEndedStackAllocator::Reset() {
+    m_bottom = 0;
+    m_top = m_totalSize;
+    m_used = 0;
+    m_peak = 0;
+}
+
+void DoubleEndedStackAllocator::UpdateUsed() {
+    m_used = m_bottom + (m_totalSize - m_top);
+    m_peak = std::max(m_peak, m_used);
+}
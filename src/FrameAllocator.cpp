@@ -0,0 +1,61 @@
+#include "FrameAllocator.h"
+#include <algorithm>    /* max */
+#include <cassert>   /* assert */
+#ifdef _DEBUG
+#include <iostream>
+#endif
+
+FrameAllocator::FrameAllocator(const std::size_t frameSize, const std::size_t nFrames, const std::size_t maxBlockSize)
+: Allocator(frameSize * nFrames), m_current{0} {
+    assert(nFrames > 0 && "A frame allocator needs at least one frame");
+    for (std::size_t i = 0; i < nFrames; ++i) {
+        m_frames.push_back(std::unique_ptr<LinearAllocator>(new LinearAllocator(frameSize, maxBlockSize)));
+    }
+    m_currentFrame = m_frames[0].get();
+}
+
+FrameAllocator::~FrameAllocator() {
+}
+
+void FrameAllocator::Init() {
+    for (auto& frame : m_frames) {
+        frame->SetRegionProvider(m_regionProvider);
+        frame->Init();
+    }
+    m_current = 0;
+    m_currentFrame = m_frames[0].get();
+    m_used = 0;
+    m_peak = 0;
+}
+
+void* FrameAllocator::Allocate(const std::size_t size, const std::size_t alignment) {
+    const std::size_t used = m_currentFrame->GetUsed();
+    void* ptr = m_currentFrame->AllocateHeaderless(size, alignment);
+    m_used += m_currentFrame->GetUsed() - used;
+    m_peak = std::max(m_peak, m_used);
+    return ptr;
+}
+
+void FrameAllocator::Free(void* ptr) {
+    assert(false && "Use NextFrame() method");
+}
+
+void FrameAllocator::NextFrame() {
+    m_current = m_current + 1 == m_frames.size() ? 0 : m_current + 1;
+    m_currentFrame = m_frames[m_current].get();
+    m_used -= m_currentFrame->GetUsed();
+    m_currentFrame->Reset();
+#ifdef _DEBUG
+    std::cout << "N" << "\tF " << m_current << "\tM " << m_used << std::endl;
+#endif
+}
+
+void FrameAllocator::Reset() {
+    for (auto& frame : m_frames) {
+        frame->Reset();
+    }
+    m_current = 0;
+    m_currentFrame = m_frames[0].get();
+    m_used = 0;
+    m_peak = 0;
+}
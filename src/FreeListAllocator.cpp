@@ -1,32 +1,49 @@
 #include "FreeListAllocator.h"
 #include "Utils.h"  /* CalculatePaddingWithHeader */
-#include <stdlib.h>     /* malloc, free */
 #include <cassert>   /* assert		*/
-#include <limits>  /* limits_max */
 #include <algorithm>    // std::max
+#include <cstring>      /* memcpy */
 
 #ifdef _DEBUG
 #include <iostream>
 #endif
 
+const std::size_t FreeListAllocator::IN_USE;
+const std::size_t FreeListAllocator::PREVIOUS_IN_USE;
+const std::size_t FreeListAllocator::FLAGS;
+const std::size_t FreeListAllocator::SMALL_BINS;
+const std::size_t FreeListAllocator::SMALL_BIN_LIMIT;
+const std::size_t FreeListAllocator::N_BINS;
+
 FreeListAllocator::FreeListAllocator(const std::size_t totalSize, const PlacementPolicy pPolicy)
 : Allocator(totalSize) {
     m_pPolicy = pPolicy;
+    m_minBlockSize = (pPolicy == FIND_BEST ? sizeof(TreeNode) : sizeof(Node)) + sizeof(std::size_t);
 }
 
 void FreeListAllocator::Init() {
     if (m_start_ptr != nullptr) {
-        free(m_start_ptr);
+        m_regionProvider->Free(m_start_ptr, m_totalSize);
         m_start_ptr = nullptr;
     }
-    m_start_ptr = malloc(m_totalSize);
+    m_start_ptr = m_regionProvider->Allocate(m_totalSize);
+    if (m_headerless) {
+        delete[] m_freeMap;
+        m_freeMap = new uint64_t[(m_totalSize / 8 + 63) / 64];
+    }
 
     this->Reset();
 }
 
 FreeListAllocator::~FreeListAllocator() {
-    free(m_start_ptr);
+    m_regionProvider->Free(m_start_ptr, m_totalSize);
     m_start_ptr = nullptr;
+    delete[] m_freeMap;
+    m_freeMap = nullptr;
+}
+
+void FreeListAllocator::SetHeaderlessMode() {
+    m_headerless = true;
 }
 
 /// Allocates a block of memory from the free list that can accommodate the requested allocation.
@@ -35,57 +52,128 @@ FreeListAllocator::~FreeListAllocator() {
 /// taking into account the required alignment. If a suitable free block is found, the function may split the block into
 /// a data block and a remaining free block, and removes the data block from the free list.
 ///
-/// The function then sets up the allocation header for the data block, updates the used memory and peak memory usage statistics,
-/// and returns a pointer to the start of the data block.
+/// The function then tags the block as in use, sets up the allocation header for the data block, updates the used memory
+/// and peak memory usage statistics, and returns a pointer to the start of the data block.
 ///
 /// @param size The size of the requested allocation.
 /// @param alignment The alignment requirement for the requested allocation.
-/// @return A pointer to the start of the allocated data block.
+/// @return A pointer to the start of the allocated data block, nullptr when no free block is large enough.
 
 void *FreeListAllocator::Allocate(const std::size_t size, const std::size_t alignment)
+{
+    if (m_headerless) {
+        assert("Alignment must be 8 at least" && alignment >= 8);
+        return AllocateWithoutHeader(size, alignment);
+    }
+    switch (m_pPolicy)
+    {
+    case FIND_BEST:
+        return AllocateWith<FIND_BEST>(size, alignment);
+    case FIND_BINNED:
+        return AllocateWith<FIND_BINNED>(size, alignment);
+    default:
+        return AllocateWith<FIND_FIRST>(size, alignment);
+    }
+}
+
+template <FreeListAllocator::PlacementPolicy Placement>
+void *FreeListAllocator::AllocateWith(const std::size_t size, const std::size_t alignment)
 {
     const std::size_t allocationHeaderSize = sizeof(FreeListAllocator::AllocationHeader);
-    const std::size_t freeHeaderSize = sizeof(FreeListAllocator::FreeHeader);
-    assert("Allocation size must be bigger" && size >= sizeof(Node));
     assert("Alignment must be 8 at least" && alignment >= 8);
+    assert(Placement == m_pPolicy && !m_headerless && "Static placement does not match the allocator");
 
     // Search through the free list for a free block that has enough space to allocate our data
     std::size_t padding;
-    Node *affectedNode,
-        *previousNode;
-    this->Find(size, alignment, padding, previousNode, affectedNode);
-    assert(affectedNode != nullptr && "Not enough memory");
+    Node *affectedNode;
+    this->FindWith<Placement>(size, alignment, padding, affectedNode);
+    if (affectedNode == nullptr) {
+        // Not enough memory, reported to the caller like the other allocators do
+        return nullptr;
+    }
 
     const std::size_t alignmentPadding = padding - allocationHeaderSize;
-    const std::size_t requiredSize = size + padding;
+    // Blocks stay 8 byte aligned so that the low bits of their size are free for the tags
+    std::size_t requiredSize = std::max((size + padding + 7) & ~(std::size_t)7, m_minBlockSize);
 
-    const std::size_t rest = affectedNode->data.blockSize - requiredSize;
+    const std::size_t blockSize = BlockSize(affectedNode);
+    const std::size_t rest = blockSize - requiredSize;
 
-    if (rest > sizeof(Node))
+    RemoveFreeWith<Placement>(affectedNode);
+    if (rest >= m_minBlockSize)
     {
         // We have to split the block into the data block and a free block of size 'rest'
         Node *newFreeNode = (Node *)((std::size_t)affectedNode + requiredSize);
-        newFreeNode->data.blockSize = rest;
-        m_freeList.insert(affectedNode, newFreeNode);
+        SetFreeBlock(newFreeNode, rest);
+        InsertFreeWith<Placement>(newFreeNode);
+    }
+    else
+    {
+        requiredSize = blockSize;
+        Node *nextNode = NextBlock(affectedNode);
+        if (nextNode != nullptr)
+        {
+            nextNode->data.blockSize |= PREVIOUS_IN_USE;
+        }
     }
-    m_freeList.remove(previousNode, affectedNode);
 
-    // Setup data block
+    // Setup data block. A free block always follows a used one, otherwise they would have been merged
     const std::size_t headerAddress = (std::size_t)affectedNode + alignmentPadding;
     const std::size_t dataAddress = headerAddress + allocationHeaderSize;
     ((FreeListAllocator::AllocationHeader *)headerAddress)->blockSize = requiredSize;
     ((FreeListAllocator::AllocationHeader *)headerAddress)->padding = alignmentPadding;
+    affectedNode->data.blockSize = requiredSize | IN_USE | PREVIOUS_IN_USE;
 
     m_used += requiredSize;
     m_peak = std::max(m_peak, m_used);
 
 #ifdef _DEBUG
-    std::cout << "A" << "\t@H " << (void *)headerAddress << "\tD@ " << (void *)dataAddress << "\tS " << ((FreeListAllocator::AllocationHeader *)headerAddress)->blockSize << "\tAP " << alignmentPadding << "\tP " << padding << "\tM " << m_used << "\tR " << rest << std::endl;
+    std::cout << "A" << "\t@H " << (void *)headerAddress << "\tD@ " << (void *)dataAddress << "\tS " << requiredSize << "\tAP " << alignmentPadding << "\tP " << padding << "\tM " << m_used << "\tR " << rest << std::endl;
+#endif
+
+    return (void *)dataAddress;
+}
+
+/// Headerless allocation: the block is exactly the rounded size, the alignment padding in front of it and the
+/// rest behind it stay free, even when they are too small to be indexed.
+void* FreeListAllocator::AllocateWithoutHeader(const std::size_t size, const std::size_t alignment) {
+    const std::size_t blockSize = HeaderlessBlockSize(size);
+    std::size_t padding;
+    Node * affectedNode;
+    this->Find(blockSize, alignment, padding, affectedNode);
+    if (affectedNode == nullptr) {
+        return nullptr;
+    }
+
+    const std::size_t freeSize = BlockSize(affectedNode);
+    const std::size_t dataAddress = (std::size_t) affectedNode + padding;
+    const std::size_t rest = freeSize - padding - blockSize;
+    RemoveFree(affectedNode);
+    if (padding != 0) {
+        AddFree(affectedNode, padding);
+    }
+    if (rest != 0) {
+        AddFree((Node *) (dataAddress + blockSize), rest);
+    }
+    MarkGranules(dataAddress, blockSize, false);
+
+    m_used += blockSize;
+    m_peak = std::max(m_peak, m_used);
+
+#ifdef _DEBUG
+    std::cout << "A" << "\tD@ " << (void *)dataAddress << "\tS " << blockSize << "\tP " << padding << "\tM " << m_used << "\tR " << rest << std::endl;
 #endif
 
     return (void *)dataAddress;
 }
 
+std::size_t FreeListAllocator::Padding(const std::size_t address, const std::size_t alignment) const {
+    if (!m_headerless) {
+        return Utils::CalculatePaddingWithHeader(address, alignment, sizeof (FreeListAllocator::AllocationHeader));
+    }
+    return address % alignment != 0 ? Utils::CalculatePadding(address, alignment) : 0;
+}
+
 /// Finds a free block in the free list that can accommodate the requested allocation.
 ///
 /// The behavior of the find operation is determined by the current allocation policy, which can be either FIND_FIRST or FIND_BEST.
@@ -93,124 +181,427 @@ void *FreeListAllocator::Allocate(const std::size_t size, const std::size_t alig
 /// If the FIND_FIRST policy is used, the function will return the first free block in the list that is large enough to accommodate the requested allocation.
 /// If the FIND_BEST policy is used, the function will return the free block in the list that best fits the requested allocation (i.e., the block with the smallest difference between its size and the requested size).
 ///
-/// The function updates the `padding`, `previousNode`, and `foundNode` parameters to provide information about the found free block.
+/// The function updates the `padding` and `foundNode` parameters to provide information about the found free block.
 ///
 /// @param size The size of the requested allocation.
 /// @param alignment The alignment requirement for the requested allocation.
 /// @param[out] padding The padding required to align the allocation within the found free block.
-/// @param[out] previousNode A pointer to the node in the free list that precedes the found free block.
 /// @param[out] foundNode A pointer to the found free block.
-void FreeListAllocator::Find(const std::size_t size, const std::size_t alignment, std::size_t &padding, Node *&previousNode, Node *&foundNode)
+void FreeListAllocator::Find(const std::size_t size, const std::size_t alignment, std::size_t &padding, Node *&foundNode)
 {
     switch (m_pPolicy)
     {
     case FIND_FIRST:
-        FindFirst(size, alignment, padding, previousNode, foundNode);
+        FindFirst(size, alignment, padding, foundNode);
         break;
     case FIND_BEST:
-        FindBest(size, alignment, padding, previousNode, foundNode);
+        FindBest(size, alignment, padding, foundNode);
+        break;
+    case FIND_BINNED:
+        FindBinned(size, alignment, padding, foundNode);
         break;
     }
 }
 
-void FreeListAllocator::FindFirst(const std::size_t size, const std::size_t alignment, std::size_t& padding, Node *& previousNode, Node *& foundNode) {
+template <FreeListAllocator::PlacementPolicy Placement>
+void FreeListAllocator::FindWith(const std::size_t size, const std::size_t alignment, std::size_t &padding, Node *&foundNode)
+{
+    if constexpr (Placement == FIND_BEST) {
+        FindBest(size, alignment, padding, foundNode);
+    } else if constexpr (Placement == FIND_BINNED) {
+        FindBinned(size, alignment, padding, foundNode);
+    } else {
+        FindFirst(size, alignment, padding, foundNode);
+    }
+}
+
+void FreeListAllocator::FindFirst(const std::size_t size, const std::size_t alignment, std::size_t& padding, Node *& foundNode) {
     //Iterate list and return the first free block with a size >= than given size
-    Node * it = m_freeList.head,
-         * itPrev = nullptr;
-    
+    Node * it = m_freeList.head;
+
     while (it != nullptr) {
-        padding = Utils::CalculatePaddingWithHeader((std::size_t)it, alignment, sizeof (FreeListAllocator::AllocationHeader));
+        padding = Padding((std::size_t)it, alignment);
         const std::size_t requiredSpace = size + padding;
-        if (it->data.blockSize >= requiredSpace) {
+        if (BlockSize(it) >= requiredSpace) {
             break;
         }
-        itPrev = it;
         it = it->next;
     }
-    previousNode = itPrev;
     foundNode = it;
 }
 
-void FreeListAllocator::FindBest(const std::size_t size, const std::size_t alignment, std::size_t& padding, Node *& previousNode, Node *& foundNode) {
-    // Iterate WHOLE list keeping a pointer to the best fit
-    std::size_t smallestDiff = std::numeric_limits<std::size_t>::max();
-    Node * bestBlock = nullptr;
-    Node * it = m_freeList.head,
-         * itPrev = nullptr;
+/// Best fit through the size-ordered tree of free blocks, in O(log N) where N is the number of free blocks.
+///
+/// The search starts at the smallest block that could hold the data with the minimum padding. Alignment may need a
+/// bigger padding for some addresses, so the following blocks (in size, then address order) are tried until one fits.
+void FreeListAllocator::FindBest(const std::size_t size, const std::size_t alignment, std::size_t& padding, Node *& foundNode) {
+    FreeHeader key;
+    key.blockSize = size + (m_headerless ? 0 : sizeof (FreeListAllocator::AllocationHeader));
+    TreeNode * it = m_freeTree.lowerBound(key);
     while (it != nullptr) {
-        padding = Utils::CalculatePaddingWithHeader((std::size_t)it, alignment, sizeof (FreeListAllocator::AllocationHeader));
+        padding = Padding((std::size_t)it, alignment);
         const std::size_t requiredSpace = size + padding;
-        if (it->data.blockSize >= requiredSpace && (it->data.blockSize - requiredSpace < smallestDiff)) {
-            bestBlock = it;
+        if ((it->data.blockSize & ~FLAGS) >= requiredSpace) {
+            break;
         }
-        itPrev = it;
-        it = it->next;
+        it = RedBlackTree<FreeHeader, FreeHeaderLess>::successor(it);
+    }
+    foundNode = (Node *) it;
+}
+
+/// Segregated fit in the style of dlmalloc small and large bins.
+///
+/// The first bin that may hold a block big enough with the minimum padding is taken from the bitmap of non-empty
+/// bins. Its blocks are tried in turn, since alignment or the range of sizes of a large bin may rule some out, then
+/// the next non-empty bin. Small bins hold a single size, so a request is usually served by the first block tried.
+void FreeListAllocator::FindBinned(const std::size_t size, const std::size_t alignment, std::size_t& padding, Node *& foundNode) {
+    const std::size_t minimumSize = (size + (m_headerless ? 0 : sizeof (FreeListAllocator::AllocationHeader)) + 7) & ~(std::size_t)7;
+    uint64_t candidates = m_binMap & (~(uint64_t) 0 << BinIndex(minimumSize));
+    while (candidates != 0) {
+        const std::size_t bin = Utils::FindFirstSet(candidates);
+        for (Node * it = m_bins[bin].head; it != nullptr; it = it->next) {
+            padding = Padding((std::size_t)it, alignment);
+            if (BlockSize(it) >= size + padding) {
+                foundNode = it;
+                return;
+            }
+        }
+        candidates &= candidates - 1;
     }
-    previousNode = itPrev;
-    foundNode = bestBlock;
+    foundNode = nullptr;
+}
+
+std::size_t FreeListAllocator::BinIndex(const std::size_t blockSize) {
+    if (blockSize < SMALL_BIN_LIMIT) {
+        return blockSize / 8;
+    }
+    // Two bins per power of two, split on the bit below the leading one
+    const std::size_t log = Utils::FindLastSet(blockSize);
+    const std::size_t bin = SMALL_BINS + 2 * (log - Utils::FindLastSet(SMALL_BIN_LIMIT)) + ((blockSize >> (log - 1)) & 1);
+    return std::min(bin, N_BINS - 1);
 }
 
 void FreeListAllocator::Free(void* ptr) {
-    // Insert it in a sorted position by the address number
+    assert(!m_headerless && "Headerless blocks are freed with FreeSized()");
+    switch (m_pPolicy)
+    {
+    case FIND_BEST:
+        FreeWith<FIND_BEST>(ptr);
+        break;
+    case FIND_BINNED:
+        FreeWith<FIND_BINNED>(ptr);
+        break;
+    default:
+        FreeWith<FIND_FIRST>(ptr);
+        break;
+    }
+}
+
+template <FreeListAllocator::PlacementPolicy Placement>
+void FreeListAllocator::FreeWith(void* ptr) {
+    assert(Placement == m_pPolicy && !m_headerless && "Static placement does not match the allocator");
+    // The block start is found through the allocation header, its neighbours through the boundary tags
     const std::size_t currentAddress = (std::size_t) ptr;
     const std::size_t headerAddress = currentAddress - sizeof (FreeListAllocator::AllocationHeader);
     const FreeListAllocator::AllocationHeader * allocationHeader{ (FreeListAllocator::AllocationHeader *) headerAddress};
 
-    Node * freeNode = (Node *) (headerAddress);
-    freeNode->data.blockSize = allocationHeader->blockSize + allocationHeader->padding;
-    freeNode->next = nullptr;
+    Node * freeNode = (Node *) (headerAddress - allocationHeader->padding);
+    assert((freeNode->data.blockSize & IN_USE) && "Block is not allocated");
 
-    Node * it = m_freeList.head;
-    Node * itPrev = nullptr;
-    while (it != nullptr) {
-        if (ptr < it) {
-            m_freeList.insert(itPrev, freeNode);
-            break;
+    m_used -= BlockSize(freeNode);
+
+    // Merge contiguous nodes
+    freeNode = CoalescenceWith<Placement>(freeNode);
+    InsertFreeWith<Placement>(freeNode);
+
+#ifdef _DEBUG
+    std::cout << "F" << "\t@ptr " <<  ptr <<"\tH@ " << (void*) freeNode << "\tS " << BlockSize(freeNode) << "\tM " << m_used << std::endl;
+#endif
+}
+
+void FreeListAllocator::FreeSized(void* ptr, const std::size_t size) {
+    if (!m_headerless) {
+        Free(ptr);
+        return;
+    }
+    const std::size_t dataAddress = (std::size_t) ptr;
+    const std::size_t blockSize = HeaderlessBlockSize(size);
+    assert(!IsFreeGranule(dataAddress) && "Block is not allocated");
+    m_used -= blockSize;
+    MarkGranules(dataAddress, blockSize, true);
+
+    // Neighbours are found through the granule map and the boundary tags of the free blocks
+    std::size_t freeAddress = dataAddress;
+    std::size_t freeSize = blockSize;
+    const std::size_t nextAddress = dataAddress + blockSize;
+    if (nextAddress < (std::size_t) m_start_ptr + (m_totalSize & ~(std::size_t)7) && IsFreeGranule(nextAddress)) {
+        Node * nextNode = (Node *) nextAddress;
+        freeSize += BlockSize(nextNode);
+        RemoveFreeIfIndexed(nextNode);
+    }
+    if (dataAddress > (std::size_t) m_start_ptr && IsFreeGranule(dataAddress - 8)) {
+        const std::size_t previousSize = *(std::size_t *) (dataAddress - sizeof(std::size_t));
+        freeAddress -= previousSize;
+        freeSize += previousSize;
+        RemoveFreeIfIndexed((Node *) freeAddress);
+    }
+    AddFree((Node *) freeAddress, freeSize);
+
+#ifdef _DEBUG
+    std::cout << "F" << "\t@ptr " << ptr << "\tH@ " << (void*) freeAddress << "\tS " << freeSize << "\tM " << m_used << std::endl;
+#endif
+}
+
+void* FreeListAllocator::Reallocate(void* ptr, const std::size_t newSize, const std::size_t alignment) {
+    if (ptr == nullptr) {
+        return Allocate(newSize, std::max(alignment, (std::size_t) 8));
+    }
+    if (m_headerless) {
+        return nullptr;
+    }
+    const std::size_t headerAddress = (std::size_t) ptr - sizeof (FreeListAllocator::AllocationHeader);
+    FreeListAllocator::AllocationHeader * allocationHeader{ (FreeListAllocator::AllocationHeader *) headerAddress};
+    Node * block = (Node *) (headerAddress - allocationHeader->padding);
+    assert((block->data.blockSize & IN_USE) && "Block is not allocated");
+
+    const std::size_t blockSize = BlockSize(block);
+    const std::size_t dataOffset = (std::size_t) ptr - (std::size_t) block;
+    const std::size_t requiredSize = std::max((dataOffset + newSize + 7) & ~(std::size_t)7, m_minBlockSize);
+
+    if (requiredSize > blockSize) {
+        Node * nextNode = NextBlock(block);
+        if (nextNode == nullptr || (nextNode->data.blockSize & IN_USE) || blockSize + BlockSize(nextNode) < requiredSize) {
+            // No room behind the block, move it
+            void* newPtr = Allocate(newSize, std::max(alignment, (std::size_t) 8));
+            if (newPtr != nullptr) {
+                std::memcpy(newPtr, ptr, blockSize - dataOffset);
+                Free(ptr);
+            }
+            return newPtr;
         }
-        itPrev = it;
-        it = it->next;
+
+        // Absorb the whole next block, its tail is given back below
+        const std::size_t mergedSize = blockSize + BlockSize(nextNode);
+        RemoveFree(nextNode);
+        block->data.blockSize = mergedSize | (block->data.blockSize & FLAGS);
+        Node * followingNode = NextBlock(block);
+        if (followingNode != nullptr) {
+            followingNode->data.blockSize |= PREVIOUS_IN_USE;
+        }
+        m_used += mergedSize - blockSize;
+        m_peak = std::max(m_peak, m_used);
     }
-    
-    m_used -= freeNode->data.blockSize;
 
-    // Merge contiguous nodes
-    Coalescence(itPrev, freeNode);  
+    ReleaseTail(block, requiredSize);
+    // Without alignment padding the header overlaps the tag, which is written last as in Allocate()
+    const std::size_t tag = block->data.blockSize;
+    allocationHeader->blockSize = BlockSize(block);
+    block->data.blockSize = tag;
 
 #ifdef _DEBUG
-    std::cout << "F" << "\t@ptr " <<  ptr <<"\tH@ " << (void*) freeNode << "\tS " << freeNode->data.blockSize << "\tM " << m_used << std::endl;
+    std::cout << "R" << "\t@ptr " << ptr << "\tH@ " << (void*) block << "\tS " << BlockSize(block) << "\tM " << m_used << std::endl;
 #endif
+    return ptr;
+}
+
+void FreeListAllocator::ReleaseTail(Node * block, const std::size_t requiredSize) {
+    const std::size_t rest = BlockSize(block) - requiredSize;
+    if (rest < m_minBlockSize) {
+        return;
+    }
+    block->data.blockSize = requiredSize | (block->data.blockSize & FLAGS);
+
+    // The tail becomes a used block of its own, then goes through the regular free path
+    Node * tail = (Node *) ((std::size_t) block + requiredSize);
+    tail->data.blockSize = rest | IN_USE | PREVIOUS_IN_USE;
+    m_used -= rest;
+    tail = Coalescence(tail);
+    InsertFree(tail);
+}
+
+/// Merges a block that is being freed with its free physical neighbours.
+///
+/// The next block is found by adding the block size and tells whether it is in use from its own tag. The previous
+/// block is only touched when the PREVIOUS_IN_USE bit is clear, in which case its size is read from its footer.
+/// Both checks are O(1), so no walk of the free list is needed.
+///
+/// @param freeNode The block being freed, still tagged as in use.
+/// @return The merged free block, not yet inserted in the free list.
+FreeListAllocator::Node* FreeListAllocator::Coalescence(Node * freeNode) {
+    switch (m_pPolicy)
+    {
+    case FIND_BEST:
+        return CoalescenceWith<FIND_BEST>(freeNode);
+    case FIND_BINNED:
+        return CoalescenceWith<FIND_BINNED>(freeNode);
+    default:
+        return CoalescenceWith<FIND_FIRST>(freeNode);
+    }
 }
 
-void FreeListAllocator::Coalescence(Node* previousNode, Node * freeNode) {   
-    if (freeNode->next != nullptr && 
-            (std::size_t) freeNode + freeNode->data.blockSize == (std::size_t) freeNode->next) {
-        freeNode->data.blockSize += freeNode->next->data.blockSize;
-        m_freeList.remove(freeNode, freeNode->next);
+template <FreeListAllocator::PlacementPolicy Placement>
+FreeListAllocator::Node* FreeListAllocator::CoalescenceWith(Node * freeNode) {
+    std::size_t blockSize = BlockSize(freeNode);
+
+    Node * nextNode = NextBlock(freeNode);
+    if (nextNode != nullptr && !(nextNode->data.blockSize & IN_USE)) {
+        blockSize += BlockSize(nextNode);
+        RemoveFreeWith<Placement>(nextNode);
 #ifdef _DEBUG
-    std::cout << "\tMerging(n) " << (void*) freeNode << " & " << (void*) freeNode->next << "\tS " << freeNode->data.blockSize << std::endl;
+    std::cout << "\tMerging(n) " << (void*) freeNode << " & " << (void*) nextNode << "\tS " << blockSize << std::endl;
 #endif
     }
-    
-    if (previousNode != nullptr &&
-            (std::size_t) previousNode + previousNode->data.blockSize == (std::size_t) freeNode) {
-        previousNode->data.blockSize += freeNode->data.blockSize;
-        m_freeList.remove(previousNode, freeNode);
+
+    if (!(freeNode->data.blockSize & PREVIOUS_IN_USE)) {
+        const std::size_t previousSize = *(std::size_t *) ((std::size_t) freeNode - sizeof(std::size_t));
+        Node * previousNode = (Node *) ((std::size_t) freeNode - previousSize);
+        blockSize += previousSize;
+        RemoveFreeWith<Placement>(previousNode);
 #ifdef _DEBUG
-    std::cout << "\tMerging(p) " << (void*) previousNode << " & " << (void*) freeNode << "\tS " << previousNode->data.blockSize << std::endl;
+    std::cout << "\tMerging(p) " << (void*) previousNode << " & " << (void*) freeNode << "\tS " << blockSize << std::endl;
 #endif
+        freeNode = previousNode;
     }
+
+    SetFreeBlock(freeNode, blockSize);
+    nextNode = NextBlock(freeNode);
+    if (nextNode != nullptr) {
+        nextNode->data.blockSize &= ~PREVIOUS_IN_USE;
+    }
+    return freeNode;
+}
+
+void FreeListAllocator::InsertFree(Node * block) {
+    switch (m_pPolicy)
+    {
+    case FIND_BEST:
+        InsertFreeWith<FIND_BEST>(block);
+        break;
+    case FIND_BINNED:
+        InsertFreeWith<FIND_BINNED>(block);
+        break;
+    default:
+        InsertFreeWith<FIND_FIRST>(block);
+        break;
+    }
+}
+
+void FreeListAllocator::RemoveFree(Node * block) {
+    switch (m_pPolicy)
+    {
+    case FIND_BEST:
+        RemoveFreeWith<FIND_BEST>(block);
+        break;
+    case FIND_BINNED:
+        RemoveFreeWith<FIND_BINNED>(block);
+        break;
+    default:
+        RemoveFreeWith<FIND_FIRST>(block);
+        break;
+    }
+}
+
+template <FreeListAllocator::PlacementPolicy Placement>
+void FreeListAllocator::InsertFreeWith(Node * block) {
+    if constexpr (Placement == FIND_BEST) {
+        m_freeTree.insert((TreeNode *) block);
+    } else if constexpr (Placement == FIND_BINNED) {
+        const std::size_t bin = BinIndex(BlockSize(block));
+        m_bins[bin].insert(nullptr, block);
+        m_binMap |= (uint64_t) 1 << bin;
+    } else {
+        m_freeList.insert(nullptr, block);
+    }
+}
+
+template <FreeListAllocator::PlacementPolicy Placement>
+void FreeListAllocator::RemoveFreeWith(Node * block) {
+    if constexpr (Placement == FIND_BEST) {
+        m_freeTree.remove((TreeNode *) block);
+    } else if constexpr (Placement == FIND_BINNED) {
+        const std::size_t bin = BinIndex(BlockSize(block));
+        m_bins[bin].remove(block);
+        if (m_bins[bin].head == nullptr) {
+            m_binMap &= ~((uint64_t) 1 << bin);
+        }
+    } else {
+        m_freeList.remove(block);
+    }
+}
+
+void FreeListAllocator::AddFree(Node * block, const std::size_t blockSize) {
+    SetFreeBlock(block, blockSize);
+    if (blockSize >= m_minBlockSize) {
+        InsertFree(block);
+    }
+}
+
+void FreeListAllocator::RemoveFreeIfIndexed(Node * block) {
+    if (BlockSize(block) >= m_minBlockSize) {
+        RemoveFree(block);
+    }
+}
+
+bool FreeListAllocator::IsFreeGranule(const std::size_t address) const {
+    const std::size_t granule = (address - (std::size_t) m_start_ptr) / 8;
+    return (m_freeMap[granule / 64] >> (granule % 64)) & 1;
+}
+
+void FreeListAllocator::MarkGranules(const std::size_t address, const std::size_t size, const bool free) {
+    std::size_t granule = (address - (std::size_t) m_start_ptr) / 8;
+    const std::size_t end = granule + size / 8;
+    // Partial words bit by bit, whole words at once
+    while (granule < end && granule % 64 != 0) {
+        m_freeMap[granule / 64] = free ? m_freeMap[granule / 64] | ((uint64_t) 1 << (granule % 64)) : m_freeMap[granule / 64] & ~((uint64_t) 1 << (granule % 64));
+        ++granule;
+    }
+    for (; granule + 64 <= end; granule += 64) {
+        m_freeMap[granule / 64] = free ? ~(uint64_t) 0 : 0;
+    }
+    for (; granule < end; ++granule) {
+        m_freeMap[granule / 64] = free ? m_freeMap[granule / 64] | ((uint64_t) 1 << (granule % 64)) : m_freeMap[granule / 64] & ~((uint64_t) 1 << (granule % 64));
+    }
+}
+
+void FreeListAllocator::SetFreeBlock(Node * block, const std::size_t blockSize) {
+    // The previous block of a free block is always in use, otherwise they would have been merged
+    block->data.blockSize = blockSize | PREVIOUS_IN_USE;
+    *(std::size_t *) ((std::size_t) block + blockSize - sizeof(std::size_t)) = blockSize;
+}
+
+FreeListAllocator::Node* FreeListAllocator::NextBlock(const Node * block) const {
+    const std::size_t nextAddress = (std::size_t) block + BlockSize(block);
+    if (nextAddress >= (std::size_t) m_start_ptr + (m_totalSize & ~(std::size_t)7)) {
+        return nullptr;
+    }
+    return (Node *) nextAddress;
 }
 
 void FreeListAllocator::Reset() {
     m_used = 0;
     m_peak = 0;
     Node * firstNode = (Node *) m_start_ptr;
-    firstNode->data.blockSize = m_totalSize;
-    firstNode->next = nullptr;
+    SetFreeBlock(firstNode, m_totalSize & ~(std::size_t)7);
     m_freeList.head = nullptr;
-    m_freeList.insert(nullptr, firstNode);
+    m_freeTree.root = nullptr;
+    for (std::size_t bin = 0; bin < N_BINS; ++bin) {
+        m_bins[bin].head = nullptr;
+    }
+    m_binMap = 0;
+    InsertFree(firstNode);
+    if (m_headerless) {
+        MarkGranules((std::size_t) m_start_ptr, m_totalSize & ~(std::size_t)7, true);
+    }
 }
 
 std::size_t FreeListAllocator::GetPeakMemoryUsage() const {
     return m_peak;
-}
\ No newline at end of file
+}
+
+// The statically dispatched entry points used by FreeListStorage
+template void* FreeListAllocator::AllocateWith<FreeListAllocator::FIND_FIRST>(const std::size_t, const std::size_t);
+template void* FreeListAllocator::AllocateWith<FreeListAllocator::FIND_BEST>(const std::size_t, const std::size_t);
+template void* FreeListAllocator::AllocateWith<FreeListAllocator::FIND_BINNED>(const std::size_t, const std::size_t);
+template void FreeListAllocator::FreeWith<FreeListAllocator::FIND_FIRST>(void*);
+template void FreeListAllocator::FreeWith<FreeListAllocator::FIND_BEST>(void*);
+template void FreeListAllocator::FreeWith<FreeListAllocator::FIND_BINNED>(void*);
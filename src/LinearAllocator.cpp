@@ -1,40 +1,65 @@
 #include "LinearAllocator.h"
 #include "Utils.h"  /* CalculatePadding */
-#include <stdlib.h>     /* malloc, free */
 #include <cassert>   /*assert		*/
 #include <algorithm>    // max
+#include <cstring>      // memcpy
 #ifdef _DEBUG
 #include <iostream>
 #endif
 
 LinearAllocator::LinearAllocator(const std::size_t totalSize)
-: Allocator(totalSize) {
+: LinearAllocator(totalSize, 0, false) {
+}
+
+LinearAllocator::LinearAllocator(const std::size_t totalSize, const std::size_t maxBlockSize, const bool keepLargest)
+: Allocator(totalSize), m_maxBlockSize{maxBlockSize}, m_keepLargest{keepLargest} {
 }
 
 void LinearAllocator::Init() {
-    if (m_start_ptr != nullptr) {
-        free(m_start_ptr);
+    ReleaseBlocks(nullptr, false);
+    if (m_reserve) {
+        m_arena.Reserve(m_regionProvider, m_totalSize, m_retainedSize);
+    } else {
+        m_arena.Allocate(m_regionProvider, m_totalSize);
     }
-    m_start_ptr = malloc(m_totalSize);
+    m_start_ptr = m_arena.GetStartPtr();
+    m_current_ptr = m_start_ptr;
+    m_currentSize = m_totalSize;
     m_offset = 0;
+    m_retiredUsed = 0;
+    m_lastAllocation = nullptr;
 }
 
 LinearAllocator::~LinearAllocator() {
-    free(m_start_ptr);
+    ReleaseBlocks(nullptr, false);
     m_start_ptr = nullptr;
 }
 
+void LinearAllocator::SetReserveMode(const std::size_t retainedSize) {
+    m_reserve = true;
+    m_retainedSize = retainedSize;
+}
+
 void* LinearAllocator::Allocate(const std::size_t size, const std::size_t alignment) {
     std::size_t padding = 0;
     std::size_t paddedAddress = 0;
-    const std::size_t currentAddress = (std::size_t)m_start_ptr + m_offset;
+    const std::size_t currentAddress = (std::size_t)m_current_ptr + m_offset;
 
-    if (alignment != 0 && m_offset % alignment != 0) {
-        // Alignment is required. Find the next aligned memory address and update offset
+    if (alignment != 0 && currentAddress % alignment != 0) {
+        // Alignment is required. Find the next aligned memory address and update offset. The address is tested, not
+        // the offset, since the data of a chained block does not start on an alignment boundary
         padding = Utils::CalculatePadding(currentAddress, alignment);
     }
 
-    if (m_offset + padding + size > m_totalSize) {
+    if (m_offset + padding + size > m_currentSize) {
+        // Leave room for the alignment padding in the new block
+        if (m_maxBlockSize == 0 || !Grow(size + alignment)) {
+            return nullptr;
+        }
+        return Allocate(size, alignment);
+    }
+    // Chained blocks are always committed
+    if (m_currentBlock == nullptr && !m_arena.EnsureCommitted(m_offset + padding + size)) {
         return nullptr;
     }
 
@@ -46,29 +71,190 @@ void* LinearAllocator::Allocate(const std::size_t size, const std::size_t alignm
     std::cout << "A" << "\t@C " << (void*) currentAddress << "\t@R " << (void*) nextAddress << "\tO " << m_offset << "\tP " << padding << std::endl;
 #endif
 
-    m_used = m_offset;
+    m_used = m_retiredUsed + m_offset;
     m_peak = std::max(m_peak, m_used);
+    m_lastAllocation = (void*) nextAddress;
 
     return (void*) nextAddress;
 }
 
+void* LinearAllocator::Reallocate(void* ptr, const std::size_t newSize, const std::size_t alignment) {
+    if (ptr != nullptr && ptr == m_lastAllocation) {
+        const std::size_t newOffset = (std::size_t) ptr - (std::size_t) m_current_ptr + newSize;
+        if (newOffset <= m_currentSize && (m_currentBlock != nullptr || m_arena.EnsureCommitted(newOffset))) {
+            m_offset = newOffset;
+            m_used = m_retiredUsed + m_offset;
+            m_peak = std::max(m_peak, m_used);
+#ifdef _DEBUG
+            std::cout << "R" << "\t@R " << ptr << "\tO " << m_offset << std::endl;
+#endif
+            return ptr;
+        }
+    }
+
+    const std::size_t extent = ptr != nullptr ? ExtentFrom(ptr) : 0;
+    void* newPtr = Allocate(newSize, alignment);
+    if (newPtr != nullptr && ptr != nullptr) {
+        std::memcpy(newPtr, ptr, std::min(extent, newSize));
+    }
+    return newPtr;
+}
+
+std::size_t LinearAllocator::ExtentFrom(const void* ptr) const {
+    const std::size_t address = (std::size_t) ptr;
+    if (address - (std::size_t) m_current_ptr <= m_offset) {
+        return (std::size_t) m_current_ptr + m_offset - address;
+    }
+    // Older chained blocks were handed out up to their end
+    for (BlockHeader* block = m_currentBlock != nullptr ? m_currentBlock->previous : nullptr; block != nullptr; block = block->previous) {
+        const std::size_t start = (std::size_t) (block + 1);
+        if (address - start < block->size) {
+            return start + block->size - address;
+        }
+    }
+    // First block, only read what is committed
+    return (std::size_t) m_start_ptr + std::min(m_arena.GetCommitted(), m_totalSize) - address;
+}
+
+std::size_t LinearAllocator::AllocateBatch(const std::size_t size, const std::size_t count, void** out, const std::size_t alignment) {
+    if (count == 0) {
+        return 0;
+    }
+    // Blocks are 'stride' bytes apart so that all of them keep the alignment of the first one
+    const std::size_t stride = alignment > 1 ? (size + alignment - 1) / alignment * alignment : size;
+    const std::size_t currentAddress = (std::size_t)m_current_ptr + m_offset;
+    std::size_t padding = 0;
+    if (alignment != 0 && currentAddress % alignment != 0) {
+        padding = Utils::CalculatePadding(currentAddress, alignment);
+    }
+
+    std::size_t fitting = 0;
+    if (m_offset + padding + size <= m_currentSize) {
+        fitting = stride != 0 ? std::min(count, (m_currentSize - m_offset - padding - size) / stride + 1) : count;
+    }
+    if (fitting == 0) {
+        if (m_maxBlockSize == 0 || !Grow(stride * count + alignment)) {
+            return 0;
+        }
+        return AllocateBatch(size, count, out, alignment);
+    }
+    const std::size_t end = m_offset + padding + (fitting - 1) * stride + size;
+    if (m_currentBlock == nullptr && !m_arena.EnsureCommitted(end)) {
+        return 0;
+    }
+
+    // One bump for the whole batch
+    const std::size_t firstAddress = currentAddress + padding;
+    for (std::size_t i = 0; i < fitting; ++i) {
+        out[i] = (void*) (firstAddress + i * stride);
+    }
+    m_offset = end;
+    m_used = m_retiredUsed + m_offset;
+    m_peak = std::max(m_peak, m_used);
+    m_lastAllocation = out[fitting - 1];
+
+#ifdef _DEBUG
+    std::cout << "AB" << "\t@C " << (void*) currentAddress << "\t@R " << (void*) firstAddress << "\tO " << m_offset << "\tN " << fitting << std::endl;
+#endif
+
+    if (fitting < count) {
+        // The rest goes to a new chained block, if any
+        return fitting + AllocateBatch(size, count - fitting, out + fitting, alignment);
+    }
+    return fitting;
+}
+
+bool LinearAllocator::Grow(const std::size_t minSize) {
+    BlockHeader* block;
+    if (m_spareBlock != nullptr && m_spareBlock->size >= minSize) {
+        block = m_spareBlock;
+        m_spareBlock = nullptr;
+    } else {
+        // Geometric growth up to the cap, unless this single allocation needs more
+        const std::size_t blockSize = std::max(std::min(m_currentSize * 2, m_maxBlockSize), minSize);
+        block = (BlockHeader*) m_regionProvider->Allocate(sizeof(BlockHeader) + blockSize);
+        if (block == nullptr) {
+            return false;
+        }
+        block->size = blockSize;
+    }
+
+#ifdef _DEBUG
+    std::cout << "G" << "\t@B " << (void*) block << "\tS " << block->size << "\tU " << m_retiredUsed + m_offset << std::endl;
+#endif
+
+    m_retiredUsed += m_offset;
+    block->previous = m_currentBlock;
+    m_currentBlock = block;
+    m_current_ptr = (void*) (block + 1);
+    m_currentSize = block->size;
+    m_offset = 0;
+    return true;
+}
+
+void LinearAllocator::ReleaseBlocks(BlockHeader* last, const bool keepSpare) {
+    BlockHeader* spare = keepSpare ? m_spareBlock : nullptr;
+    if (!keepSpare && m_spareBlock != nullptr) {
+        FreeBlock(m_spareBlock);
+    }
+
+    BlockHeader* block = m_currentBlock;
+    while (block != last) {
+        BlockHeader* previous = block->previous;
+        if (keepSpare && (spare == nullptr || block->size > spare->size)) {
+            if (spare != nullptr) {
+                FreeBlock(spare);
+            }
+            spare = block;
+        } else {
+            FreeBlock(block);
+        }
+        block = previous;
+    }
+
+    m_spareBlock = spare;
+    m_currentBlock = last;
+    m_current_ptr = last != nullptr ? (void*) (last + 1) : m_start_ptr;
+    m_currentSize = last != nullptr ? last->size : m_totalSize;
+}
+
+void LinearAllocator::FreeToMarker(const Marker& marker) {
+    if (marker.block != m_currentBlock) {
+        ReleaseBlocks(marker.block, m_keepLargest);
+    }
+    m_offset = marker.offset;
+    m_retiredUsed = marker.retiredUsed;
+    m_lastAllocation = nullptr;
+    m_used = m_retiredUsed + m_offset;
+#ifdef _DEBUG
+    std::cout << "M" << "	@B " << (void*) marker.block << "	O " << m_offset << "	U " << m_used << std::endl;
+#endif
+}
+
 void LinearAllocator::Free(void* ptr) {
     assert(false && "Use Reset() method");
 }
 
 void LinearAllocator::Deallocate()
 {
+    ReleaseBlocks(nullptr, false);
     if (m_start_ptr != nullptr)
     {
-        free(m_start_ptr);  // 这将释放从系统请求的内存
+        m_arena.Release();  // 这将释放从系统请求的内存
         m_start_ptr = nullptr;
+        m_current_ptr = nullptr;
         m_offset = 0;
         m_totalSize = 0;
+        m_currentSize = 0;
     }
 }
 
 void LinearAllocator::Reset() {
+    ReleaseBlocks(nullptr, m_keepLargest);
+    m_arena.Trim();
     m_offset = 0;
+    m_retiredUsed = 0;
+    m_lastAllocation = nullptr;
     m_used = 0;
     m_peak = 0;
 }
@@ -0,0 +1,60 @@
+#include "LockedAllocator.h"
+#include <utility>  /* move */
+
+LockedAllocator::LockedAllocator(std::unique_ptr<Allocator> allocator)
+: Allocator(allocator->GetOffset()), m_allocator{std::move(allocator)} {
+
+}
+
+void LockedAllocator::Init() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_allocator->Init();
+    m_used = m_allocator->GetUsed();
+    m_peak = m_allocator->GetPeak();
+}
+
+LockedAllocator::~LockedAllocator() {
+
+}
+
+void* LockedAllocator::Allocate(const std::size_t size, const std::size_t alignment) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    void* ptr = m_allocator->Allocate(size, alignment);
+    m_used = m_allocator->GetUsed();
+    m_peak = m_allocator->GetPeak();
+    return ptr;
+}
+
+void LockedAllocator::Free(void* ptr) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_allocator->Free(ptr);
+    m_used = m_allocator->GetUsed();
+}
+
+void LockedAllocator::FreeSized(void* ptr, const std::size_t size) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_allocator->FreeSized(ptr, size);
+    m_used = m_allocator->GetUsed();
+}
+
+void* LockedAllocator::Reallocate(void* ptr, const std::size_t newSize, const std::size_t alignment) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    void* newPtr = m_allocator->Reallocate(ptr, newSize, alignment);
+    m_used = m_allocator->GetUsed();
+    m_peak = m_allocator->GetPeak();
+    return newPtr;
+}
+
+std::size_t LockedAllocator::AllocateBatch(const std::size_t size, const std::size_t count, void** out, const std::size_t alignment) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const std::size_t allocated = m_allocator->AllocateBatch(size, count, out, alignment);
+    m_used = m_allocator->GetUsed();
+    m_peak = m_allocator->GetPeak();
+    return allocated;
+}
+
+void LockedAllocator::FreeBatch(void** ptrs, const std::size_t count) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_allocator->FreeBatch(ptrs, count);
+    m_used = m_allocator->GetUsed();
+}
@@ -0,0 +1,197 @@
+#include "OwnerPoolAllocator.h"
+#include "ThreadRegistry.h"
+#include <stdlib.h>     /* calloc, free */
+#include <cassert>   /* assert */
+#include <new>       /* placement new */
+#ifdef _DEBUG
+#include <iostream>
+#endif
+
+OwnerPoolAllocator::OwnerPoolAllocator(const std::size_t totalSize, const std::size_t chunkSize, const std::size_t spanSize, const std::size_t maxThreads)
+: Allocator(totalSize), m_chunkSize{chunkSize}, m_spanSize{spanSize}, m_maxThreads{maxThreads}, m_nextSpan{0} {
+    assert(chunkSize >= sizeof(Node) && "Chunk size must be greater or equal to 8");
+    assert((spanSize & (spanSize - 1)) == 0 && "Span size must be a power of two");
+    assert(totalSize % spanSize == 0 && "Total Size must be a multiple of Span Size");
+    assert(maxThreads > 0 && "At least one thread is required");
+    // Chunks keep the 16 byte alignment of the span
+    m_spanOffset = (sizeof(SpanHeader) + 15) & ~(std::size_t) 15;
+    assert(spanSize >= m_spanOffset + chunkSize && "Span size is too small for a single chunk");
+    m_nSpans = totalSize / spanSize;
+}
+
+void OwnerPoolAllocator::Init() {
+    if (m_start_ptr != nullptr) {
+        m_regionProvider->Free(m_start_ptr, m_totalSize);
+        m_start_ptr = nullptr;
+    }
+    // Aligning spans to their size lets Free() find the header with a mask
+    m_start_ptr = m_regionProvider->Allocate(m_totalSize, m_spanSize);
+    free(m_heaps);
+    m_heaps = (ThreadHeap*) calloc(m_maxThreads, sizeof(ThreadHeap));
+    this->Reset();
+}
+
+OwnerPoolAllocator::~OwnerPoolAllocator() {
+    m_regionProvider->Free(m_start_ptr, m_totalSize);
+    free(m_heaps);
+}
+
+void* OwnerPoolAllocator::Allocate(const std::size_t size, const std::size_t alignment) {
+    assert(size <= m_chunkSize && "Allocation size must not be bigger than the chunk size");
+    const std::size_t owner = ThreadRegistry::CurrentIndex();
+    if (owner >= m_maxThreads) {
+        // More live threads than thread heaps
+        return nullptr;
+    }
+    ThreadHeap& heap = m_heaps[owner];
+
+    Node* chunk = heap.current != nullptr ? AllocateFromSpan(heap.current) : nullptr;
+    if (chunk == nullptr) {
+        SpanHeader* span = FindSpan(heap, owner);
+        if (span == nullptr) {
+            return nullptr;
+        }
+        chunk = AllocateFromSpan(span);
+    }
+    heap.allocatedChunks.store(heap.allocatedChunks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+#ifdef _DEBUG
+    std::cout << "A" << "\t@S " << (void*) heap.current << "\t@R " << (void*) chunk << "\tT " << owner << std::endl;
+#endif
+    return (void*) chunk;
+}
+
+void OwnerPoolAllocator::Free(void* ptr) {
+    // A thread without a heap owns no span, its frees are all remote
+    const std::size_t thread = ThreadRegistry::CurrentIndex();
+    SpanHeader* span = SpanOf(ptr);
+    Node* chunk = (Node*) ptr;
+    if (span->owner == thread) {
+        chunk->next = span->localFree;
+        span->localFree = chunk;
+    } else {
+        // Release so the owner sees the chunk content written before the free
+        Node* head = span->remoteFree.load(std::memory_order_relaxed);
+        do {
+            chunk->next = head;
+        } while (!span->remoteFree.compare_exchange_weak(head, chunk, std::memory_order_release, std::memory_order_relaxed));
+    }
+    if (thread < m_maxThreads) {
+        ThreadHeap& heap = m_heaps[thread];
+        heap.freedChunks.store(heap.freedChunks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    } else {
+        m_outsideFreedChunks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+#ifdef _DEBUG
+    std::cout << (span->owner == thread ? "F" : "RF") << "\t@S " << (void*) span << "\t@F " << ptr << "\tT " << thread << std::endl;
+#endif
+}
+
+OwnerPoolAllocator::Node* OwnerPoolAllocator::AllocateFromSpan(SpanHeader* span) {
+    Node* chunk = span->localFree;
+    if (chunk != nullptr) {
+        span->localFree = chunk->next;
+        return chunk;
+    }
+    if (span->bumpOffset + m_chunkSize <= m_spanSize) {
+        chunk = (Node*) ((std::size_t) span + span->bumpOffset);
+        span->bumpOffset += m_chunkSize;
+        return chunk;
+    }
+    // Everything the other threads freed comes back at once
+    if (span->remoteFree.load(std::memory_order_relaxed) != nullptr) {
+        chunk = span->remoteFree.exchange(nullptr, std::memory_order_acquire);
+        span->localFree = chunk->next;
+        return chunk;
+    }
+    return nullptr;
+}
+
+OwnerPoolAllocator::SpanHeader* OwnerPoolAllocator::FindSpan(ThreadHeap& heap, const std::size_t owner) {
+    // The spans are tried in turn from the one after the current span, so none is starved
+    SpanHeader* start = heap.current != nullptr && heap.current->next != nullptr ? heap.current->next : heap.spans;
+    SpanHeader* candidate = start;
+    while (candidate != nullptr) {
+        if (HasFreeChunk(candidate)) {
+            heap.current = candidate;
+            return candidate;
+        }
+        candidate = candidate->next != nullptr ? candidate->next : heap.spans;
+        if (candidate == start) {
+            break;
+        }
+    }
+
+    SpanHeader* span = AcquireSpan(owner);
+    if (span == nullptr) {
+        return nullptr;
+    }
+    span->next = heap.spans;
+    heap.spans = span;
+    heap.current = span;
+    return span;
+}
+
+OwnerPoolAllocator::SpanHeader* OwnerPoolAllocator::AcquireSpan(const std::size_t owner) {
+    std::size_t index;
+    {
+        std::lock_guard<std::mutex> lock(m_spanMutex);
+        if (m_nextSpan == m_nSpans) {
+            return nullptr;
+        }
+        index = m_nextSpan++;
+    }
+    SpanHeader* span = (SpanHeader*) ((std::size_t) m_start_ptr + index * m_spanSize);
+    span->owner = owner;
+    span->next = nullptr;
+    span->localFree = nullptr;
+    span->bumpOffset = m_spanOffset;
+    new (&span->remoteFree) std::atomic<Node*>(nullptr);
+
+#ifdef _DEBUG
+    std::cout << "S" << "\t@S " << (void*) span << "\tT " << owner << std::endl;
+#endif
+    return span;
+}
+
+void OwnerPoolAllocator::Reset() {
+    for (std::size_t t = 0; t < m_maxThreads; ++t) {
+        m_heaps[t].current = nullptr;
+        m_heaps[t].spans = nullptr;
+        m_heaps[t].allocatedChunks.store(0, std::memory_order_relaxed);
+        m_heaps[t].freedChunks.store(0, std::memory_order_relaxed);
+    }
+    m_outsideFreedChunks.store(0, std::memory_order_relaxed);
+    m_nextSpan = 0;
+    m_used = 0;
+    m_peak = 0;
+}
+
+std::size_t OwnerPoolAllocator::GetUsed() const {
+    // Chunks freed by a thread may have been allocated by another, only the sum is meaningful
+    std::size_t allocated = 0;
+    std::size_t freed = m_outsideFreedChunks.load(std::memory_order_relaxed);
+    for (std::size_t t = 0; t < m_maxThreads; ++t) {
+        freed += m_heaps[t].freedChunks.load(std::memory_order_relaxed);
+        allocated += m_heaps[t].allocatedChunks.load(std::memory_order_relaxed);
+    }
+    return allocated > freed ? (allocated - freed) * m_chunkSize : 0;
+}
+
+std::size_t OwnerPoolAllocator::GetPeak() const {
+    std::lock_guard<std::mutex> lock(m_spanMutex);
+    return m_nextSpan * m_spanSize;
+}
+
+std::size_t OwnerPoolAllocator::GetOwnedSpanCount() const {
+    const std::size_t thread = ThreadRegistry::CurrentIndex();
+    if (thread >= m_maxThreads) {
+        return 0;
+    }
+    std::size_t count = 0;
+    for (SpanHeader* span = m_heaps[thread].spans; span != nullptr; span = span->next) {
+        ++count;
+    }
+    return count;
+}
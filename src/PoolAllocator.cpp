@@ -1,32 +1,54 @@
 #include "PoolAllocator.h"
 #include <assert.h>
 #include <stdint.h>
-#include <stdlib.h>     /* malloc, free */
 #include <algorithm>    //max
 #ifdef _DEBUG
 #include <iostream>
 #endif
 
 PoolAllocator::PoolAllocator(const std::size_t totalSize, const std::size_t chunkSize)
-: Allocator(totalSize) {
+: PoolAllocator(totalSize, chunkSize, 0, 0) {
+}
+
+PoolAllocator::PoolAllocator(const std::size_t totalSize, const std::size_t chunkSize, const std::size_t spanSize, const std::size_t maxEmptySpans)
+: Allocator(totalSize), m_spanSize{spanSize}, m_maxEmptySpans{maxEmptySpans}, m_emptySpans{0}, m_nSpans{0} {
     assert(chunkSize >= 8 && "Chunk size must be greater or equal to 8");
     assert(totalSize % chunkSize == 0 && "Total Size must be a multiple of Chunk Size");
     this->m_chunkSize = chunkSize;
+
+    // Chunks in a span keep the 16 byte alignment of the initial region
+    m_spanOffset = (sizeof(SpanHeader) + 15) & ~(std::size_t) 15;
+    m_chunksPerSpan = 0;
+    if (spanSize != 0) {
+        assert((spanSize & (spanSize - 1)) == 0 && "Span size must be a power of two");
+        assert(spanSize >= m_spanOffset + chunkSize && "Span size is too small for a single chunk");
+        m_chunksPerSpan = (spanSize - m_spanOffset) / chunkSize;
+    }
 }
 
 void PoolAllocator::Init() {
-    m_start_ptr = malloc(m_totalSize);
+    if (m_start_ptr != nullptr) {
+        m_regionProvider->Free(m_start_ptr, m_totalSize);
+        m_start_ptr = nullptr;
+    }
+    m_start_ptr = m_regionProvider->Allocate(m_totalSize);
     this->Reset();
 }
 
 PoolAllocator::~PoolAllocator() {
-    free(m_start_ptr);
+    ReleaseSpans();
+    m_regionProvider->Free(m_start_ptr, m_totalSize);
 }
 
 void *PoolAllocator::Allocate(const std::size_t allocationSize, const std::size_t alignment) {
     assert(allocationSize == this->m_chunkSize && "Allocation size must be equal to chunk size");
 
-    Node * freePosition = m_freeList.pop();
+    Node * freePosition = nullptr;
+    if (m_freeList.head != nullptr) {
+        freePosition = m_freeList.pop();
+    } else if (m_spanSize != 0) {
+        freePosition = AllocateFromSpans();
+    }
 
     assert(freePosition != nullptr && "The pool allocator is full");
 
@@ -39,23 +61,207 @@ void *PoolAllocator::Allocate(const std::size_t allocationSize, const std::size_
     return (void*) freePosition;
 }
 
+std::size_t PoolAllocator::AllocateBatch(const std::size_t allocationSize, const std::size_t count, void** out, const std::size_t alignment) {
+    assert(allocationSize == this->m_chunkSize && "Allocation size must be equal to chunk size");
+
+    // Detach the first 'count' chunks of the free list with a single head update
+    std::size_t allocated = 0;
+    Node* node = m_freeList.head;
+    while (allocated < count && node != nullptr) {
+        out[allocated++] = (void*) node;
+        node = node->next;
+    }
+    m_freeList.head = node;
+
+    if (m_spanSize != 0) {
+        while (allocated < count) {
+            Node* chunk = AllocateFromSpans();
+            if (chunk == nullptr) {
+                break;
+            }
+            out[allocated++] = (void*) chunk;
+        }
+    }
+
+    m_used += allocated * m_chunkSize;
+    m_peak = std::max(m_peak, m_used);
+#ifdef _DEBUG
+    std::cout << "AB" << "\t@S " << m_start_ptr << "\tN " << allocated << "\tM " << m_used << std::endl;
+#endif
+    return allocated;
+}
+
+PoolAllocator::Node* PoolAllocator::AllocateFromSpans() {
+    SpanHeader* span = m_spans;
+    if (span == nullptr || span->usedChunks == m_chunksPerSpan) {
+        span = AcquireSpan();
+        if (span == nullptr) {
+            return nullptr;
+        }
+    }
+    if (span->usedChunks == 0) {
+        --m_emptySpans;
+    }
+    Node* chunk;
+    if (span->freeList != nullptr) {
+        chunk = span->freeList;
+        span->freeList = chunk->next;
+    } else {
+        chunk = (Node *) ((std::size_t) span + span->bumpOffset);
+        span->bumpOffset += m_chunkSize;
+    }
+    if (++span->usedChunks == m_chunksPerSpan) {
+        // Full spans go to the back so the front always has room if any span has
+        UnlinkSpan(span);
+        LinkSpanBack(span);
+    }
+    return chunk;
+}
+
 void PoolAllocator::Free(void * ptr) {
     m_used -= m_chunkSize;
 
-    m_freeList.push((Node *) ptr);
+    if (m_spanSize == 0 || InInitialRegion(ptr)) {
+        m_freeList.push((Node *) ptr);
+    } else {
+        FreeToSpan((Node *) ptr);
+    }
 
 #ifdef _DEBUG
     std::cout << "F" << "\t@S " << m_start_ptr << "\t@F " << ptr << "\tM " << m_used << std::endl;
 #endif
 }
 
+void PoolAllocator::FreeBatch(void** ptrs, const std::size_t count) {
+    m_used -= count * m_chunkSize;
+
+    // Chunks of the initial region are linked privately and spliced onto the free list at once
+    Node* first = nullptr;
+    Node* last = nullptr;
+    for (std::size_t i = 0; i < count; ++i) {
+        Node* node = (Node *) ptrs[i];
+        if (m_spanSize != 0 && !InInitialRegion(node)) {
+            FreeToSpan(node);
+            continue;
+        }
+        if (last == nullptr) {
+            first = node;
+        } else {
+            last->next = node;
+        }
+        last = node;
+    }
+    if (last != nullptr) {
+        last->next = m_freeList.head;
+        m_freeList.head = first;
+    }
+
+#ifdef _DEBUG
+    std::cout << "FB" << "\t@S " << m_start_ptr << "\tN " << count << "\tM " << m_used << std::endl;
+#endif
+}
+
+void PoolAllocator::FreeToSpan(Node* node) {
+    SpanHeader* span = SpanOf(node);
+    node->next = span->freeList;
+    span->freeList = node;
+    if (span->usedChunks-- == m_chunksPerSpan) {
+        UnlinkSpan(span);
+        LinkSpanFront(span);
+    }
+    if (span->usedChunks == 0) {
+        if (m_emptySpans >= m_maxEmptySpans) {
+            ReleaseSpan(span);
+        } else {
+            ++m_emptySpans;
+        }
+    }
+}
+
 void PoolAllocator::Reset() {
+    ReleaseSpans();
     m_used = 0;
     m_peak = 0;
+    m_freeList.head = nullptr;
     // Create a linked-list with all free positions
     const int nChunks = m_totalSize / m_chunkSize;
     for (int i = 0; i < nChunks; ++i) {
         std::size_t address = (std::size_t) m_start_ptr + i * m_chunkSize;
         m_freeList.push((Node *) address);
     }
-}
\ No newline at end of file
+}
+
+PoolAllocator::SpanHeader* PoolAllocator::AcquireSpan() {
+    // Aligning spans to their size lets Free() find the header with a mask
+    SpanHeader* span = (SpanHeader*) m_regionProvider->Allocate(m_spanSize, m_spanSize);
+    if (span == nullptr) {
+        return nullptr;
+    }
+    span->freeList = nullptr;
+    span->bumpOffset = m_spanOffset;
+    span->usedChunks = 0;
+    LinkSpanFront(span);
+    ++m_nSpans;
+    ++m_emptySpans;
+#ifdef _DEBUG
+    std::cout << "S+" << "\t@S " << (void*) span << "\tN " << m_nSpans << std::endl;
+#endif
+    return span;
+}
+
+void PoolAllocator::ReleaseSpan(SpanHeader* span) {
+    UnlinkSpan(span);
+    --m_nSpans;
+#ifdef _DEBUG
+    std::cout << "S-" << "\t@S " << (void*) span << "\tN " << m_nSpans << std::endl;
+#endif
+    m_regionProvider->Free(span, m_spanSize);
+}
+
+void PoolAllocator::ReleaseSpans() {
+    while (m_spans != nullptr) {
+        ReleaseSpan(m_spans);
+    }
+    m_emptySpans = 0;
+}
+
+void PoolAllocator::LinkSpanFront(SpanHeader* span) {
+    // The head's 'previous' points to the tail
+    span->next = m_spans;
+    if (m_spans != nullptr) {
+        span->previous = m_spans->previous;
+        m_spans->previous = span;
+    } else {
+        span->previous = span;
+    }
+    m_spans = span;
+}
+
+void PoolAllocator::LinkSpanBack(SpanHeader* span) {
+    span->next = nullptr;
+    if (m_spans == nullptr) {
+        span->previous = span;
+        m_spans = span;
+        return;
+    }
+    SpanHeader* tail = m_spans->previous;
+    tail->next = span;
+    span->previous = tail;
+    m_spans->previous = span;
+}
+
+void PoolAllocator::UnlinkSpan(SpanHeader* span) {
+    if (span == m_spans) {
+        m_spans = span->next;
+        if (m_spans != nullptr) {
+            m_spans->previous = span->previous;
+        }
+        return;
+    }
+    span->previous->next = span->next;
+    if (span->next != nullptr) {
+        span->next->previous = span->previous;
+    } else {
+        m_spans->previous = span->previous;
+    }
+}
@@ -0,0 +1,463 @@
+/**
+ * malloc/free interposition library, loaded with LD_PRELOAD=liballocpreload.so.
+ *
+ * Routes malloc, free, calloc, realloc, the aligned variants and every
+ * operator new/delete to the allocators of this project. Configured with
+ * environment variables read on the first allocation:
+ *
+ *   ALLOCATOR                 tlsf (default), freelist, threadcache or libc
+ *   ALLOCATOR_HEAP_SIZE       bytes of the main heap (default 4GB, address space only until touched)
+ *   ALLOCATOR_SMALL           none (default) or slab, front heap for requests up to 4KB
+ *   ALLOCATOR_SMALL_HEAP_SIZE bytes of the small heap (default 1GB)
+ *   ALLOCATOR_REGION          mmap (default) or thp
+ *   ALLOCATOR_STATS           1 to print the peak usage of every heap on exit
+ *
+ * Allocators that are not thread safe are serialized behind a mutex. Memory
+ * the allocators need for themselves, and every allocation made while one of
+ * them is running, is served by glibc, so the allocators can use malloc and
+ * new freely. Every heap carves its regions from one reserved address range,
+ * which is how free() tells our blocks from glibc ones. When a heap is
+ * exhausted the request falls back to glibc too.
+ */
+#include "Allocator.h"
+#include "RegionProvider.h"
+#include "TLSFAllocator.h"
+#include "FreeListAllocator.h"
+#include "ThreadCacheAllocator.h"
+#include "SlabAllocator.h"
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <cstdint>      /* uint32_t */
+#include <dlfcn.h>      /* dlsym */
+#include <errno.h>
+#include <pthread.h>    /* pthread_atfork */
+#include <stdio.h>      /* snprintf */
+#include <stdlib.h>     /* getenv, strtoull, atexit */
+#include <string.h>     /* memcpy, memset, strcmp */
+#include <sys/mman.h>   /* mmap, mprotect, madvise */
+#include <unistd.h>     /* write */
+
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void __libc_free(void* ptr);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+}
+
+namespace {
+    // Precedes every block we hand out
+    struct BlockHeader {
+        std::size_t size;
+        // Distance from the address returned by the heap to the user pointer
+        uint32_t offset;
+        uint32_t heap;
+    };
+    const std::size_t HEADER_SIZE = 16;
+    static_assert(sizeof(BlockHeader) == HEADER_SIZE, "The header must keep user pointers 16 byte aligned");
+
+    const std::size_t DEFAULT_HEAP_SIZE = (std::size_t) 4 << 30;
+    const std::size_t DEFAULT_SMALL_HEAP_SIZE = (std::size_t) 1 << 30;
+
+    enum HeapIndex {
+        SMALL_HEAP,
+        MAIN_HEAP,
+        HEAP_COUNT
+    };
+
+    /**
+     * Hands out consecutive pieces of one reserved range. Only used while the
+     * heaps are built, so it needs no locking, and what is freed is decommitted
+     * but never reused.
+     */
+    class RangeRegionProvider : public RegionProvider {
+    private:
+        std::size_t m_start = 0;
+        std::size_t m_end = 0;
+        std::size_t m_next = 0;
+    public:
+        bool Map(const std::size_t size, const bool transparentHugePages) {
+            void* range = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (range == MAP_FAILED) {
+                return false;
+            }
+#ifdef MADV_HUGEPAGE
+            if (transparentHugePages) {
+                madvise(range, size, MADV_HUGEPAGE);
+            }
+#endif
+            m_start = m_next = (std::size_t) range;
+            m_end = m_start + size;
+            return true;
+        }
+
+        bool Owns(const void* ptr) const { return (std::size_t) ptr - m_start < m_end - m_start; }
+
+        virtual void* Allocate(const std::size_t size, const std::size_t alignment) override {
+            const std::size_t pageSize = GetPageSize();
+            const std::size_t align = alignment > pageSize ? alignment : pageSize;
+            const std::size_t start = (m_next + align - 1) & ~(align - 1);
+            const std::size_t length = (size + pageSize - 1) & ~(pageSize - 1);
+            if (start + length > m_end || mprotect((void*) start, length, PROT_READ | PROT_WRITE) != 0) {
+                return nullptr;
+            }
+            m_next = start + length;
+            return (void*) start;
+        }
+
+        virtual void Free(void* ptr, const std::size_t size) override {
+            if (ptr != nullptr) {
+                madvise(ptr, size, MADV_DONTNEED);
+            }
+        }
+
+        virtual const char* GetName() const override { return "range"; }
+    };
+
+    struct Heap {
+        Allocator* allocator = nullptr;
+        std::mutex mutex;
+        // False for allocators that do their own locking
+        bool locked = true;
+        // Largest request this heap serves, header and alignment included
+        std::size_t maxSize = 0;
+    };
+
+    enum State {
+        UNINITIALIZED,
+        READY,
+        // ALLOCATOR=libc, or the heaps could not be built
+        DISABLED
+    };
+
+    std::atomic<int> g_state{UNINITIALIZED};
+    std::mutex g_initMutex;
+    RangeRegionProvider g_provider;
+    Heap g_heaps[HEAP_COUNT];
+    ThreadCacheAllocator* g_threadCache = nullptr;
+    std::atomic<std::size_t> g_fallbacks{0};
+
+    // Set while our code runs: anything it allocates goes to glibc. Initial-exec TLS never allocates.
+    __thread bool t_inside __attribute__((tls_model("initial-exec"))) = false;
+
+    struct ReentrancyGuard {
+        ReentrancyGuard() { t_inside = true; }
+        ~ReentrancyGuard() { t_inside = false; }
+    };
+
+    std::size_t EnvSize(const char* name, const std::size_t defaultValue) {
+        const char* value = getenv(name);
+        return value != nullptr && *value != '\0' ? (std::size_t) strtoull(value, nullptr, 0) : defaultValue;
+    }
+
+    bool EnvIs(const char* name, const char* expected, const char* defaultValue) {
+        const char* value = getenv(name);
+        return strcmp(value != nullptr ? value : defaultValue, expected) == 0;
+    }
+
+    template <class T, class... Args>
+    T* Construct(Args... args) {
+        void* memory = __libc_malloc(sizeof(T));
+        return memory != nullptr ? new (memory) T(args...) : nullptr;
+    }
+
+    void ForkPrepare() {
+        g_initMutex.lock();
+        for (Heap& heap : g_heaps) {
+            heap.mutex.lock();
+        }
+        if (g_threadCache != nullptr) {
+            g_threadCache->LockAll();
+        }
+    }
+
+    void ForkRelease() {
+        if (g_threadCache != nullptr) {
+            g_threadCache->UnlockAll();
+        }
+        for (std::size_t i = HEAP_COUNT; i > 0; --i) {
+            g_heaps[i - 1].mutex.unlock();
+        }
+        g_initMutex.unlock();
+    }
+
+    void PrintStats() {
+        ReentrancyGuard guard;
+        static const char* const NAMES[HEAP_COUNT] = {"small", "main"};
+        char line[256];
+        for (std::size_t i = 0; i < HEAP_COUNT; ++i) {
+            if (g_heaps[i].allocator != nullptr) {
+                const int length = snprintf(line, sizeof(line), "allocpreload: %s heap peak %zu bytes, in use %zu bytes\n",
+                                            NAMES[i], g_heaps[i].allocator->GetPeak(), g_heaps[i].allocator->GetUsed());
+                write(2, line, length);
+            }
+        }
+        const int length = snprintf(line, sizeof(line), "allocpreload: %zu requests fell back to glibc\n", g_fallbacks.load());
+        write(2, line, length);
+    }
+
+    bool BuildHeaps() {
+        const std::size_t heapSize = EnvSize("ALLOCATOR_HEAP_SIZE", DEFAULT_HEAP_SIZE);
+        const bool small = EnvIs("ALLOCATOR_SMALL", "slab", "none");
+        const std::size_t smallHeapSize = small ? EnvSize("ALLOCATOR_SMALL_HEAP_SIZE", DEFAULT_SMALL_HEAP_SIZE) : 0;
+
+        // Twice the heaps leaves room for the alignment of every region and the internal heaps of threadcache
+        if (!g_provider.Map(2 * (heapSize + smallHeapSize) + ((std::size_t) 1 << 30), EnvIs("ALLOCATOR_REGION", "thp", "mmap"))) {
+            return false;
+        }
+        RegionProvider::SetDefault(&g_provider);
+
+        Heap& mainHeap = g_heaps[MAIN_HEAP];
+        if (EnvIs("ALLOCATOR", "freelist", "tlsf")) {
+            mainHeap.allocator = Construct<FreeListAllocator>(heapSize, FreeListAllocator::FIND_BEST);
+        } else if (EnvIs("ALLOCATOR", "threadcache", "tlsf")) {
+            // Threads past the first 256 live ones have no cache and go to the locked central pools
+            g_threadCache = Construct<ThreadCacheAllocator>(heapSize, (std::size_t) 256);
+            mainHeap.allocator = g_threadCache;
+            mainHeap.locked = false;
+        } else {
+            mainHeap.allocator = Construct<TLSFAllocator>(heapSize);
+        }
+        mainHeap.maxSize = heapSize;
+
+        if (small) {
+            Heap& smallHeap = g_heaps[SMALL_HEAP];
+            smallHeap.allocator = Construct<SlabAllocator>(smallHeapSize);
+            smallHeap.maxSize = SlabSizeClasses::MAX_SIZE;
+        }
+
+        for (Heap& heap : g_heaps) {
+            if (heap.allocator != nullptr) {
+                heap.allocator->Init();
+            }
+        }
+        RegionProvider::SetDefault(nullptr);
+        return mainHeap.allocator != nullptr;
+    }
+
+    bool EnsureInitialized() {
+        const int state = g_state.load(std::memory_order_acquire);
+        if (state != UNINITIALIZED) {
+            return state == READY;
+        }
+
+        ReentrancyGuard guard;
+        std::lock_guard<std::mutex> lock(g_initMutex);
+        if (g_state.load(std::memory_order_relaxed) == UNINITIALIZED) {
+            const bool ready = !EnvIs("ALLOCATOR", "libc", "tlsf") && BuildHeaps();
+            if (ready) {
+                pthread_atfork(ForkPrepare, ForkRelease, ForkRelease);
+                if (EnvIs("ALLOCATOR_STATS", "1", "0")) {
+                    atexit(PrintStats);
+                }
+            }
+            g_state.store(ready ? READY : DISABLED, std::memory_order_release);
+        }
+        return g_state.load(std::memory_order_relaxed) == READY;
+    }
+
+    BlockHeader* HeaderOf(const void* ptr) { return (BlockHeader*) ((std::size_t) ptr - HEADER_SIZE); }
+
+    void* HeapAllocate(const std::size_t size, const std::size_t alignment) {
+        // Heaps hand out 16 byte aligned blocks, bigger alignments are reached by moving the user pointer
+        const std::size_t slack = alignment > HEADER_SIZE ? alignment - HEADER_SIZE : 0;
+        const std::size_t blockSize = size + HEADER_SIZE + slack;
+        if (blockSize < size) {
+            return nullptr;
+        }
+
+        ReentrancyGuard guard;
+        const uint32_t index = g_heaps[SMALL_HEAP].allocator != nullptr && blockSize <= g_heaps[SMALL_HEAP].maxSize ? SMALL_HEAP : MAIN_HEAP;
+        Heap& heap = g_heaps[index];
+        void* block = nullptr;
+        if (blockSize <= heap.maxSize) {
+            if (heap.locked) {
+                std::lock_guard<std::mutex> lock(heap.mutex);
+                block = heap.allocator->Allocate(blockSize, HEADER_SIZE);
+            } else {
+                block = heap.allocator->Allocate(blockSize, HEADER_SIZE);
+            }
+        }
+        if (block == nullptr) {
+            ++g_fallbacks;
+            return __libc_memalign(alignment > HEADER_SIZE ? alignment : HEADER_SIZE, size);
+        }
+
+        const std::size_t user = ((std::size_t) block + HEADER_SIZE + alignment - 1) & ~(alignment - 1);
+        BlockHeader* header = HeaderOf((void*) user);
+        header->size = size;
+        header->offset = (uint32_t) (user - (std::size_t) block);
+        header->heap = index;
+        return (void*) user;
+    }
+
+    void HeapFree(void* ptr) {
+        ReentrancyGuard guard;
+        const BlockHeader* header = HeaderOf(ptr);
+        Heap& heap = g_heaps[header->heap];
+        void* block = (void*) ((std::size_t) ptr - header->offset);
+        if (heap.locked) {
+            std::lock_guard<std::mutex> lock(heap.mutex);
+            heap.allocator->Free(block);
+        } else {
+            heap.allocator->Free(block);
+        }
+    }
+
+    void* AlignedAllocate(const std::size_t alignment, const std::size_t size) {
+        if (t_inside || !EnsureInitialized()) {
+            return __libc_memalign(alignment, size);
+        }
+        return HeapAllocate(size, alignment > HEADER_SIZE ? alignment : HEADER_SIZE);
+    }
+
+    bool IsPowerOfTwo(const std::size_t value) { return value != 0 && (value & (value - 1)) == 0; }
+
+    void* NewOrThrow(const std::size_t size, const std::size_t alignment) {
+        void* ptr = AlignedAllocate(alignment, size != 0 ? size : 1);
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+}
+
+extern "C" {
+
+/// Lets a process check that the library is loaded and routing requests to our heaps.
+int allocpreload_active() {
+    return EnsureInitialized() ? 1 : 0;
+}
+
+void* malloc(size_t size) {
+    if (t_inside || !EnsureInitialized()) {
+        return __libc_malloc(size);
+    }
+    void* ptr = HeapAllocate(size, HEADER_SIZE);
+    if (ptr == nullptr) {
+        errno = ENOMEM;
+    }
+    return ptr;
+}
+
+void free(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    if (!g_provider.Owns(ptr)) {
+        __libc_free(ptr);
+        return;
+    }
+    HeapFree(ptr);
+}
+
+void* calloc(size_t count, size_t size) {
+    if (t_inside || !EnsureInitialized()) {
+        return __libc_calloc(count, size);
+    }
+    size_t total;
+    if (__builtin_mul_overflow(count, size, &total)) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+    void* ptr = HeapAllocate(total, HEADER_SIZE);
+    if (ptr == nullptr) {
+        errno = ENOMEM;
+        return nullptr;
+    }
+    memset(ptr, 0, total);
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (ptr == nullptr) {
+        return malloc(size);
+    }
+    if (!g_provider.Owns(ptr)) {
+        return __libc_realloc(ptr, size);
+    }
+    if (size == 0) {
+        free(ptr);
+        return nullptr;
+    }
+    BlockHeader* header = HeaderOf(ptr);
+    if (size <= header->size) {
+        // Shrinks in place, the block keeps its original size for a later growth
+        return ptr;
+    }
+    void* newPtr = malloc(size);
+    if (newPtr != nullptr) {
+        memcpy(newPtr, ptr, header->size);
+        free(ptr);
+    }
+    return newPtr;
+}
+
+int posix_memalign(void** memptr, size_t alignment, size_t size) {
+    if (!IsPowerOfTwo(alignment) || alignment % sizeof(void*) != 0) {
+        return EINVAL;
+    }
+    void* ptr = AlignedAllocate(alignment, size);
+    if (ptr == nullptr) {
+        return ENOMEM;
+    }
+    *memptr = ptr;
+    return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    if (!IsPowerOfTwo(alignment)) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    return AlignedAllocate(alignment, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    return aligned_alloc(alignment, size);
+}
+
+void* valloc(size_t size) {
+    return AlignedAllocate(RegionProvider::GetPageSize(), size);
+}
+
+size_t malloc_usable_size(void* ptr) {
+    if (ptr == nullptr) {
+        return 0;
+    }
+    if (g_provider.Owns(ptr)) {
+        return HeaderOf(ptr)->size;
+    }
+    typedef size_t (*UsableSize)(void*);
+    static UsableSize libcUsableSize = nullptr;
+    if (libcUsableSize == nullptr) {
+        ReentrancyGuard guard;
+        libcUsableSize = (UsableSize) dlsym(RTLD_NEXT, "malloc_usable_size");
+    }
+    return libcUsableSize != nullptr ? libcUsableSize(ptr) : 0;
+}
+
+}
+
+void* operator new(std::size_t size) { return NewOrThrow(size, HEADER_SIZE); }
+void* operator new[](std::size_t size) { return NewOrThrow(size, HEADER_SIZE); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return malloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return malloc(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return NewOrThrow(size, (std::size_t) alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return NewOrThrow(size, (std::size_t) alignment); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return AlignedAllocate((std::size_t) alignment, size); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return AlignedAllocate((std::size_t) alignment, size); }
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete[](void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { free(ptr); }
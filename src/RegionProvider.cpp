@@ -0,0 +1,206 @@
+#include "RegionProvider.h"
+#include <stdlib.h>     /* malloc, free, posix_memalign */
+#include <string.h>     /* strcmp */
+#include <sys/mman.h>   /* mmap, munmap, madvise */
+#include <unistd.h>     /* sysconf */
+#include <algorithm>    /* max */
+#include <cassert>   /* assert */
+#ifdef _DEBUG
+#include <iostream>
+#endif
+
+const std::size_t RegionProvider::HUGE_PAGE_SIZE;
+
+namespace {
+
+std::size_t RoundUp(const std::size_t size, const std::size_t granularity) {
+    return (size + granularity - 1) & ~(granularity - 1);
+}
+
+// Maps 'length' bytes aligned to 'alignment' by over-mapping and trimming both ends
+void* MapAligned(const std::size_t length, const std::size_t alignment, const int protection = PROT_READ | PROT_WRITE, const int extraFlags = 0) {
+    const std::size_t pageSize = RegionProvider::GetPageSize();
+    const std::size_t slack = alignment > pageSize ? alignment : 0;
+    void* mapping = mmap(nullptr, length + slack, protection, MAP_PRIVATE | MAP_ANONYMOUS | extraFlags, -1, 0);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+    if (slack == 0) {
+        return mapping;
+    }
+    const std::size_t start = (std::size_t) mapping;
+    const std::size_t aligned = RoundUp(start, alignment);
+    if (aligned != start) {
+        munmap(mapping, aligned - start);
+    }
+    if (slack - (aligned - start) != 0) {
+        munmap((void*) (aligned + length), slack - (aligned - start));
+    }
+    return (void*) aligned;
+}
+
+class MallocRegionProvider : public RegionProvider {
+public:
+    virtual void* Allocate(const std::size_t size, const std::size_t alignment) override {
+        if (alignment == 0) {
+            return malloc(size);
+        }
+        void* ptr = nullptr;
+        return posix_memalign(&ptr, std::max(alignment, sizeof(void*)), size) == 0 ? ptr : nullptr;
+    }
+
+    virtual void Free(void* ptr, const std::size_t size) override { free(ptr); }
+
+    virtual const char* GetName() const override { return "malloc"; }
+};
+
+class MmapRegionProvider : public RegionProvider {
+public:
+    virtual void* Allocate(const std::size_t size, const std::size_t alignment) override {
+        return MapAligned(RoundUp(size, GetPageSize()), alignment);
+    }
+
+    virtual void Free(void* ptr, const std::size_t size) override {
+        if (ptr != nullptr) {
+            munmap(ptr, RoundUp(size, GetPageSize()));
+        }
+    }
+
+    virtual void* Reserve(const std::size_t size, const std::size_t alignment) override {
+        // Inaccessible and not charged against the commit limit until committed
+        return MapAligned(RoundUp(size, GetPageSize()), alignment, PROT_NONE, MAP_NORESERVE);
+    }
+
+    virtual bool Commit(void* ptr, const std::size_t size) override {
+        return mprotect(ptr, size, PROT_READ | PROT_WRITE) == 0;
+    }
+
+    virtual void Decommit(void* ptr, const std::size_t size) override {
+        // MADV_DONTNEED drops the pages right away, MADV_FREE would leave them in the RSS until there is memory pressure
+        madvise(ptr, size, MADV_DONTNEED);
+        mprotect(ptr, size, PROT_NONE);
+    }
+
+    virtual const char* GetName() const override { return "mmap"; }
+};
+
+class HugeTlbRegionProvider : public RegionProvider {
+public:
+    virtual void* Allocate(const std::size_t size, const std::size_t alignment) override {
+        // The fallback maps the same rounded length so that Free does not need to know which path was taken
+        const std::size_t length = RoundUp(size, HUGE_PAGE_SIZE);
+#ifdef MAP_HUGETLB
+        if (alignment <= HUGE_PAGE_SIZE) {
+            void* ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (ptr != MAP_FAILED) {
+                return ptr;
+            }
+        }
+#endif
+#ifdef _DEBUG
+        std::cout << "R" << "\tMAP_HUGETLB failed, falling back to mmap\tS " << length << std::endl;
+#endif
+        return MapAligned(length, alignment);
+    }
+
+    virtual void Free(void* ptr, const std::size_t size) override {
+        if (ptr != nullptr) {
+            munmap(ptr, RoundUp(size, HUGE_PAGE_SIZE));
+        }
+    }
+
+    // Huge pages cannot be reserved lazily, the region is mapped up front and only decommitted
+    virtual void Decommit(void* ptr, const std::size_t size) override {
+        madvise(ptr, size, MADV_DONTNEED);
+    }
+
+    virtual std::size_t GetCommitGranularity() const override { return HUGE_PAGE_SIZE; }
+
+    virtual const char* GetName() const override { return "hugetlb"; }
+};
+
+class TransparentHugePageRegionProvider : public MmapRegionProvider {
+public:
+    virtual void* Allocate(const std::size_t size, const std::size_t alignment) override {
+        // Huge page alignment lets the kernel back the whole region with huge pages
+        const std::size_t length = RoundUp(size, HUGE_PAGE_SIZE);
+        void* ptr = MapAligned(length, std::max(alignment, HUGE_PAGE_SIZE));
+#ifdef MADV_HUGEPAGE
+        if (ptr != nullptr) {
+            madvise(ptr, length, MADV_HUGEPAGE);
+        }
+#endif
+        return ptr;
+    }
+
+    virtual void Free(void* ptr, const std::size_t size) override {
+        if (ptr != nullptr) {
+            munmap(ptr, RoundUp(size, HUGE_PAGE_SIZE));
+        }
+    }
+
+    virtual void* Reserve(const std::size_t size, const std::size_t alignment) override {
+        const std::size_t length = RoundUp(size, HUGE_PAGE_SIZE);
+        void* ptr = MapAligned(length, std::max(alignment, HUGE_PAGE_SIZE), PROT_NONE, MAP_NORESERVE);
+#ifdef MADV_HUGEPAGE
+        if (ptr != nullptr) {
+            madvise(ptr, length, MADV_HUGEPAGE);
+        }
+#endif
+        return ptr;
+    }
+
+    // Committing whole huge pages lets the kernel back them without splitting
+    virtual std::size_t GetCommitGranularity() const override { return HUGE_PAGE_SIZE; }
+
+    virtual const char* GetName() const override { return "thp"; }
+};
+
+const char* const BACKEND_NAMES[] = {"malloc", "mmap", "hugetlb", "thp"};
+
+RegionProvider* defaultProvider = nullptr;
+
+}
+
+RegionProvider* RegionProvider::Get(const Backend backend) {
+    static MallocRegionProvider mallocProvider;
+    static MmapRegionProvider mmapProvider;
+    static HugeTlbRegionProvider hugeTlbProvider;
+    static TransparentHugePageRegionProvider thpProvider;
+
+    switch (backend) {
+        case MALLOC:
+            return &mallocProvider;
+        case MMAP:
+            return &mmapProvider;
+        case HUGETLB:
+            return &hugeTlbProvider;
+        case THP:
+            return &thpProvider;
+    }
+    assert(false && "Unknown region provider backend");
+    return nullptr;
+}
+
+bool RegionProvider::FromName(const char* name, Backend& backend) {
+    for (int i = MALLOC; i <= THP; ++i) {
+        if (strcmp(name, BACKEND_NAMES[i]) == 0) {
+            backend = (Backend) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+RegionProvider* RegionProvider::GetDefault() {
+    return defaultProvider != nullptr ? defaultProvider : Get(MALLOC);
+}
+
+void RegionProvider::SetDefault(RegionProvider* provider) {
+    defaultProvider = provider;
+}
+
+std::size_t RegionProvider::GetPageSize() {
+    static const std::size_t pageSize = (std::size_t) sysconf(_SC_PAGESIZE);
+    return pageSize;
+}
@@ -0,0 +1,125 @@
+#include "ShardedAllocator.h"
+#include "ThreadRegistry.h"
+#include <cassert>   /* assert */
+#include <algorithm> /* max */
+#include <sched.h>   /* sched_getcpu */
+#include <thread>    /* hardware_concurrency */
+#ifdef _DEBUG
+#include <iostream>
+#endif
+
+ShardedAllocator::ShardedAllocator(const std::size_t totalSize, const FreeListAllocator::PlacementPolicy pPolicy, const std::size_t nShards)
+: Allocator(totalSize), m_pPolicy{pPolicy} {
+    m_nShards = nShards != 0 ? nShards : std::max(1u, std::thread::hardware_concurrency());
+    // Slices stay 64 byte aligned
+    m_shardSize = totalSize / m_nShards & ~(std::size_t) 63;
+    assert(m_shardSize > 0 && "Total size is too small for the shards");
+}
+
+void ShardedAllocator::Init() {
+    DestroyShards();
+    m_start_ptr = m_regionProvider->Allocate(m_totalSize);
+    m_shards = new Shard[m_nShards];
+    for (std::size_t i = 0; i < m_nShards; ++i) {
+        m_shards[i].provider.SetSlice((void*) ((std::size_t) m_start_ptr + i * m_shardSize), m_shardSize);
+        m_shards[i].allocator = new FreeListAllocator(m_shardSize, m_pPolicy);
+        m_shards[i].allocator->SetRegionProvider(&m_shards[i].provider);
+        m_shards[i].allocator->Init();
+    }
+    m_used = 0;
+    m_peak = 0;
+}
+
+ShardedAllocator::~ShardedAllocator() {
+    DestroyShards();
+}
+
+void ShardedAllocator::DestroyShards() {
+    if (m_shards != nullptr) {
+        for (std::size_t i = 0; i < m_nShards; ++i) {
+            delete m_shards[i].allocator;
+        }
+        delete[] m_shards;
+        m_shards = nullptr;
+    }
+    m_regionProvider->Free(m_start_ptr, m_totalSize);
+    m_start_ptr = nullptr;
+}
+
+void* ShardedAllocator::Allocate(const std::size_t size, const std::size_t alignment) {
+    Shard& shard = LockShard();
+    void* ptr = shard.allocator->Allocate(size, alignment);
+    shard.mutex.unlock();
+    if (ptr == nullptr) {
+        // The shard is full, the neighbours may still have room
+        const std::size_t first = &shard - m_shards;
+        for (std::size_t i = 1; i < m_nShards && ptr == nullptr; ++i) {
+            Shard& neighbour = m_shards[(first + i) % m_nShards];
+            std::lock_guard<std::mutex> lock(neighbour.mutex);
+            ptr = neighbour.allocator->Allocate(size, alignment);
+        }
+    }
+
+#ifdef _DEBUG
+    std::cout << "A" << "\t@R " << ptr << "\tS " << size << "\tH " << ShardOf(ptr) << std::endl;
+#endif
+    return ptr;
+}
+
+void ShardedAllocator::Free(void* ptr) {
+    const std::size_t owner = ShardOf(ptr);
+    assert(owner < m_nShards && "Pointer does not belong to this allocator");
+    std::lock_guard<std::mutex> lock(m_shards[owner].mutex);
+    m_shards[owner].allocator->Free(ptr);
+
+#ifdef _DEBUG
+    std::cout << "F" << "\t@F " << ptr << "\tH " << owner << std::endl;
+#endif
+}
+
+void* ShardedAllocator::Reallocate(void* ptr, const std::size_t newSize, const std::size_t alignment) {
+    if (ptr == nullptr) {
+        return Allocate(newSize, alignment);
+    }
+    const std::size_t owner = ShardOf(ptr);
+    assert(owner < m_nShards && "Pointer does not belong to this allocator");
+    std::lock_guard<std::mutex> lock(m_shards[owner].mutex);
+    return m_shards[owner].allocator->Reallocate(ptr, newSize, alignment);
+}
+
+ShardedAllocator::Shard& ShardedAllocator::LockShard() {
+    const std::size_t home = CurrentCpu() % m_nShards;
+    // Another thread on the same CPU, or one that migrated, holds the lock: any free neighbour will do
+    for (std::size_t i = 0; i < m_nShards; ++i) {
+        Shard& shard = m_shards[(home + i) % m_nShards];
+        if (shard.mutex.try_lock()) {
+            return shard;
+        }
+    }
+    m_shards[home].mutex.lock();
+    return m_shards[home];
+}
+
+std::size_t ShardedAllocator::CurrentCpu() {
+    // glibc answers from the rseq area when the kernel supports it, without a system call
+    const int cpu = sched_getcpu();
+    return cpu >= 0 ? (std::size_t) cpu : ThreadRegistry::CurrentIndex();
+}
+
+std::size_t ShardedAllocator::GetUsed() const {
+    std::size_t used = 0;
+    for (std::size_t i = 0; i < m_nShards; ++i) {
+        std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+        used += m_shards[i].allocator->GetUsed();
+    }
+    return used;
+}
+
+std::size_t ShardedAllocator::GetPeak() const {
+    std::size_t peak = 0;
+    for (std::size_t i = 0; i < m_nShards; ++i) {
+        std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+        peak += m_shards[i].allocator->GetPeak();
+    }
+    return peak;
+}
@@ -0,0 +1,165 @@
+#include "SlabAllocator.h"
+#include "Utils.h"  /* CalculatePadding */
+#include <cassert>   /* assert */
+#include <algorithm>    /* max */
+#ifdef _DEBUG
+#include <iostream>
+#endif
+
+constexpr std::size_t SlabAllocator::SPAN_SIZE;
+
+SlabAllocator::SlabAllocator(const std::size_t totalSize)
+: Allocator(totalSize) {
+    assert(totalSize >= SPAN_SIZE && "Total size must fit at least one span");
+}
+
+void SlabAllocator::Init() {
+    if (m_start_ptr != nullptr) {
+        m_regionProvider->Free(m_start_ptr, m_nSpans * SPAN_SIZE);
+        delete[] m_spans;
+    }
+    m_nSpans = m_totalSize / SPAN_SIZE;
+    // Spans are SPAN_SIZE aligned so that chunks keep the alignment of their size class
+    m_start_ptr = m_regionProvider->Allocate(m_nSpans * SPAN_SIZE, SPAN_SIZE);
+    m_spans = new Span[m_nSpans];
+
+    this->Reset();
+}
+
+SlabAllocator::~SlabAllocator() {
+    m_regionProvider->Free(m_start_ptr, m_nSpans * SPAN_SIZE);
+    m_start_ptr = nullptr;
+    delete[] m_spans;
+    m_spans = nullptr;
+}
+
+void* SlabAllocator::Allocate(const std::size_t size, const std::size_t alignment) {
+    assert(size <= SlabSizeClasses::MAX_SIZE && "Allocation size is bigger than the largest size class");
+
+    const std::size_t sizeClass = AlignedClass(size, alignment);
+    const std::size_t chunkSize = SlabSizeClasses::ClassSize(sizeClass);
+
+    Span* span = m_partialSpans[sizeClass];
+    if (span == nullptr) {
+        span = AcquireSpan(sizeClass);
+        if (span == nullptr) {
+            return nullptr;
+        }
+        LinkPartial(span);
+    }
+
+    void* chunk;
+    if (span->freeList.head != nullptr) {
+        chunk = (void*) span->freeList.pop();
+    } else {
+        // Never used chunks are carved on demand
+        chunk = (void*) ((std::size_t) m_start_ptr + (span - m_spans) * SPAN_SIZE + span->bumpOffset);
+        span->bumpOffset += chunkSize;
+    }
+
+    if (++span->allocated == SPAN_SIZE / chunkSize) {
+        UnlinkPartial(span);
+    }
+
+    m_used += chunkSize;
+    m_peak = std::max(m_peak, m_used);
+#ifdef _DEBUG
+    std::cout << "A" << "\t@S " << m_start_ptr << "\t@R " << chunk << "\tC " << chunkSize << "\tM " << m_used << std::endl;
+#endif
+
+    return chunk;
+}
+
+void SlabAllocator::Free(void* ptr) {
+    Span* span = &m_spans[((std::size_t) ptr - (std::size_t) m_start_ptr) / SPAN_SIZE];
+    const std::size_t chunkSize = SlabSizeClasses::ClassSize(span->sizeClass);
+
+    if (span->allocated == SPAN_SIZE / chunkSize) {
+        // The span was full, so it is not in the partial list yet
+        LinkPartial(span);
+    }
+    span->freeList.push((Node*) ptr);
+    --span->allocated;
+    m_used -= chunkSize;
+
+    // Keep the last partial span of a class around so that alloc/free pairs do not thrash
+    if (span->allocated == 0 && (m_partialSpans[span->sizeClass] != span || span->next != nullptr)) {
+        UnlinkPartial(span);
+        ReleaseSpan(span);
+    }
+
+#ifdef _DEBUG
+    std::cout << "F" << "\t@S " << m_start_ptr << "\t@F " << ptr << "\tC " << chunkSize << "\tM " << m_used << std::endl;
+#endif
+}
+
+void SlabAllocator::Reset() {
+    m_used = 0;
+    m_peak = 0;
+    m_nextSpan = 0;
+    m_freeSpans = nullptr;
+    for (std::size_t i = 0; i < SlabSizeClasses::COUNT; ++i) {
+        m_partialSpans[i] = nullptr;
+    }
+}
+
+SlabAllocator::Span* SlabAllocator::AcquireSpan(const std::size_t sizeClass) {
+    Span* span;
+    if (m_freeSpans != nullptr) {
+        span = m_freeSpans;
+        m_freeSpans = span->next;
+    } else if (m_nextSpan < m_nSpans) {
+        span = &m_spans[m_nextSpan++];
+    } else {
+        return nullptr;
+    }
+
+    span->previous = nullptr;
+    span->next = nullptr;
+    span->freeList.head = nullptr;
+    span->sizeClass = sizeClass;
+    span->allocated = 0;
+    span->bumpOffset = 0;
+    return span;
+}
+
+void SlabAllocator::ReleaseSpan(Span* span) {
+    span->next = m_freeSpans;
+    m_freeSpans = span;
+}
+
+void SlabAllocator::LinkPartial(Span* span) {
+    Span*& head = m_partialSpans[span->sizeClass];
+    span->previous = nullptr;
+    span->next = head;
+    if (head != nullptr) {
+        head->previous = span;
+    }
+    head = span;
+}
+
+void SlabAllocator::UnlinkPartial(Span* span) {
+    if (span->previous != nullptr) {
+        span->previous->next = span->next;
+    } else {
+        m_partialSpans[span->sizeClass] = span->next;
+    }
+    if (span->next != nullptr) {
+        span->next->previous = span->previous;
+    }
+    span->previous = nullptr;
+    span->next = nullptr;
+}
+
+std::size_t SlabAllocator::AlignedClass(const std::size_t size, const std::size_t alignment) {
+    if (alignment <= SlabSizeClasses::GRANULE) {
+        return SlabSizeClasses::SizeToClass(size);
+    }
+    // Spans are SPAN_SIZE aligned, so a chunk is aligned when its class size is a multiple of the alignment
+    std::size_t sizeClass = SlabSizeClasses::SizeToClass(std::max(size, alignment));
+    while (sizeClass < SlabSizeClasses::COUNT && SlabSizeClasses::ClassSize(sizeClass) % alignment != 0) {
+        ++sizeClass;
+    }
+    assert(sizeClass < SlabSizeClasses::COUNT && "Alignment is bigger than the largest size class");
+    return sizeClass;
+}
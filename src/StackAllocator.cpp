@@ -1,7 +1,8 @@
 #include "StackAllocator.h"
 #include "Utils.h"  /* CalculatePadding */
-#include <stdlib.h>     /* malloc, free */
 #include <algorithm>    /* max */
+#include <cassert>   /* assert */
+#include <cstring>   /* memcpy */
 #ifdef _DEBUG
 #include <iostream>
 #endif
@@ -12,24 +13,31 @@ StackAllocator::StackAllocator(const std::size_t totalSize)
 }
 
 void StackAllocator::Init() {
-    if (m_start_ptr != nullptr) {
-        free(m_start_ptr);
+    if (m_reserve) {
+        m_arena.Reserve(m_regionProvider, m_totalSize, m_retainedSize);
+    } else {
+        m_arena.Allocate(m_regionProvider, m_totalSize);
     }
-    m_start_ptr = malloc(m_totalSize);
+    m_start_ptr = m_arena.GetStartPtr();
     m_offset = 0;
+    m_lastAllocation = nullptr;
 }
 
 StackAllocator::~StackAllocator() {
-    free(m_start_ptr);
     m_start_ptr = nullptr;
 }
 
+void StackAllocator::SetReserveMode(const std::size_t retainedSize) {
+    m_reserve = true;
+    m_retainedSize = retainedSize;
+}
+
 void* StackAllocator::Allocate(const std::size_t size, const std::size_t alignment) {
     const std::size_t currentAddress = (std::size_t)m_start_ptr + m_offset;
 
     std::size_t padding = Utils::CalculatePaddingWithHeader(currentAddress, alignment, sizeof (AllocationHeader));
 
-    if (m_offset + padding + size > m_totalSize) {
+    if (m_offset + padding + size > m_totalSize || !m_arena.EnsureCommitted(m_offset + padding + size)) {
         return nullptr;
     }
     m_offset += padding;
@@ -47,10 +55,69 @@ void* StackAllocator::Allocate(const std::size_t size, const std::size_t alignme
 #endif
     m_used = m_offset;
     m_peak = std::max(m_peak, m_used);
+    m_lastAllocation = (void*) nextAddress;
 
     return (void*) nextAddress;
 }
 
+void* StackAllocator::Reallocate(void* ptr, const std::size_t newSize, const std::size_t alignment) {
+    if (ptr != nullptr && ptr == m_lastAllocation) {
+        const std::size_t newOffset = (std::size_t) ptr - (std::size_t) m_start_ptr + newSize;
+        if (newOffset <= m_totalSize && m_arena.EnsureCommitted(newOffset)) {
+            m_offset = newOffset;
+            m_used = m_offset;
+            m_peak = std::max(m_peak, m_used);
+#ifdef _DEBUG
+            std::cout << "R" << "\t@R " << ptr << "\tO " << m_offset << std::endl;
+#endif
+            return ptr;
+        }
+        return nullptr;
+    }
+
+    // Every live block lies below the top, so the data to keep is at most what separates it from the top
+    const std::size_t extent = ptr != nullptr ? (std::size_t) m_start_ptr + m_offset - (std::size_t) ptr : 0;
+    void* newPtr = Allocate(newSize, alignment);
+    if (newPtr != nullptr && ptr != nullptr) {
+        std::memcpy(newPtr, ptr, std::min(extent, newSize));
+    }
+    return newPtr;
+}
+
+void* StackAllocator::AllocateHeaderless(const std::size_t size, const std::size_t alignment) {
+    const std::size_t currentAddress = (std::size_t)m_start_ptr + m_offset;
+
+    std::size_t padding = 0;
+    if (alignment != 0 && currentAddress % alignment != 0) {
+        padding = Utils::CalculatePadding(currentAddress, alignment);
+    }
+
+    if (m_offset + padding + size > m_totalSize || !m_arena.EnsureCommitted(m_offset + padding + size)) {
+        return nullptr;
+    }
+    m_offset += padding + size;
+
+#ifdef _DEBUG
+    std::cout << "A" << "	@C " << (void*) currentAddress << "	@R " << (void*) (currentAddress + padding) << "	O " << m_offset << "	P " << padding << std::endl;
+#endif
+    m_used = m_offset;
+    m_peak = std::max(m_peak, m_used);
+    m_lastAllocation = (void*) (currentAddress + padding);
+
+    return (void*) (currentAddress + padding);
+}
+
+void StackAllocator::FreeToMarker(const Marker marker) {
+    assert(marker <= m_offset && "Marker is above the top of the stack");
+    m_offset = marker;
+    m_used = m_offset;
+    m_lastAllocation = nullptr;
+
+#ifdef _DEBUG
+    std::cout << "M" << "	@S " << m_start_ptr << "	O " << m_offset << std::endl;
+#endif
+}
+
 void StackAllocator::Free(void *ptr) {
     // Move offset back to clear address
     const std::size_t currentAddress = (std::size_t) ptr;
@@ -59,14 +126,29 @@ void StackAllocator::Free(void *ptr) {
 
     m_offset = currentAddress - allocationHeader->padding - (std::size_t) m_start_ptr;
     m_used = m_offset;
+    m_lastAllocation = nullptr;
 
 #ifdef _DEBUG
     std::cout << "F" << "\t@C " << (void*) currentAddress << "\t@F " << (void*) ((char*) m_start_ptr + m_offset) << "\tO " << m_offset << std::endl;
 #endif
 }
 
+void StackAllocator::FreeSized(void *ptr, const std::size_t size) {
+    // The padding left by an allocation freed before may still sit between the block and the top
+    assert((std::size_t) ptr + size <= (std::size_t) m_start_ptr + m_offset && "Only the top allocation can be freed");
+    m_offset = (std::size_t) ptr - (std::size_t) m_start_ptr;
+    m_used = m_offset;
+    m_lastAllocation = nullptr;
+
+#ifdef _DEBUG
+    std::cout << "F" << "\t@C " << ptr << "\tO " << m_offset << std::endl;
+#endif
+}
+
 void StackAllocator::Reset() {
+    m_arena.Trim();
     m_offset = 0;
     m_used = 0;
+    m_lastAllocation = nullptr;
     m_peak = 0;
 }
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "TLSFAllocator.h"
+#include "Utils.h"  /* FindFirstSet, FindLastSet */
+#include <cassert>   /* assert */
+#include <algorithm>    /* max */
+#ifdef _DEBUG
+#include <iostream>
+#endif
+
+const std::size_t TLSFAllocator::ALIGN_SIZE_LOG2;
+const std::size_t TLSFAllocator::ALIGN_SIZE;
+const std::size_t TLSFAllocator::SL_INDEX_COUNT_LOG2;
+const std::size_t TLSFAllocator::SL_INDEX_COUNT;
+const std::size_t TLSFAllocator::FL_INDEX_MAX;
+const std::size_t TLSFAllocator::FL_INDEX_SHIFT;
+const std::size_t TLSFAllocator::FL_INDEX_COUNT;
+const std::size_t TLSFAllocator::SMALL_BLOCK_SIZE;
+const std::size_t TLSFAllocator::FREE_BIT;
+const std::size_t TLSFAllocator::BLOCK_HEADER_SIZE;
+const std::size_t TLSFAllocator::MIN_BLOCK_SIZE;
+
+TLSFAllocator::TLSFAllocator(const std::size_t totalSize)
+: Allocator(totalSize) {
+    assert(totalSize >= 2 * BLOCK_HEADER_SIZE + MIN_BLOCK_SIZE && "Total size is too small");
+    assert(totalSize < ((std::size_t) 1 << FL_INDEX_MAX) && "Total size is too big for the first level index");
+}
+
+void TLSFAllocator::Init() {
+    if (m_start_ptr != nullptr) {
+        m_regionProvider->Free(m_start_ptr, m_totalSize);
+        m_start_ptr = nullptr;
+    }
+    m_start_ptr = m_regionProvider->Allocate(m_totalSize);
+
+    this->Reset();
+}
+
+TLSFAllocator::~TLSFAllocator() {
+    m_regionProvider->Free(m_start_ptr, m_totalSize);
+    m_start_ptr = nullptr;
+}
+
+void* TLSFAllocator::Allocate(const std::size_t size, const std::size_t alignment) {
+    const std::size_t adjustedSize = std::max((size + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1), MIN_BLOCK_SIZE);
+    // A leading gap created by alignment must be big enough to become a free block on its own
+    const std::size_t gapMinimum = sizeof(BlockHeader);
+    const std::size_t searchSize = alignment > ALIGN_SIZE ? adjustedSize + alignment + gapMinimum : adjustedSize;
+
+    std::size_t fl, sl;
+    MappingSearch(searchSize, fl, sl);
+    BlockHeader* block = FindSuitable(fl, sl);
+    if (block == nullptr) {
+        return nullptr;
+    }
+    RemoveFree(block);
+
+    if (alignment > ALIGN_SIZE) {
+        const std::size_t payload = (std::size_t) block + BLOCK_HEADER_SIZE;
+        std::size_t aligned = (payload + alignment - 1) & ~(alignment - 1);
+        if (aligned != payload && aligned - payload < gapMinimum) {
+            aligned = (payload + gapMinimum + alignment - 1) & ~(alignment - 1);
+        }
+        if (aligned != payload) {
+            // Give the leading gap back as a free block
+            BlockHeader* alignedBlock = Split(block, aligned - payload - BLOCK_HEADER_SIZE);
+            InsertFree(block);
+            block = alignedBlock;
+        }
+    }
+
+    if (BlockSize(block) >= adjustedSize + sizeof(BlockHeader)) {
+        InsertFree(Split(block, adjustedSize));
+    }
+    block->size &= ~FREE_BIT;
+
+    m_used += BlockSize(block) + BLOCK_HEADER_SIZE;
+    m_peak = std::max(m_peak, m_used);
+
+    void* dataAddress = (void*) ((std::size_t) block + BLOCK_HEADER_SIZE);
+#ifdef _DEBUG
+    std::cout << "A" << "\t@H " << (void*) block << "\tD@ " << dataAddress << "\tS " << BlockSize(block) << "\tM " << m_used << std::endl;
+#endif
+    return dataAddress;
+}
+
+void TLSFAllocator::Free(void* ptr) {
+    BlockHeader* block = (BlockHeader*) ((std::size_t) ptr - BLOCK_HEADER_SIZE);
+    assert(!IsFree(block) && "Block is already free");
+
+    m_used -= BlockSize(block) + BLOCK_HEADER_SIZE;
+
+#ifdef _DEBUG
+    std::cout << "F" << "\t@ptr " << ptr << "\tH@ " << (void*) block << "\tS " << BlockSize(block) << "\tM " << m_used << std::endl;
+#endif
+
+    // Immediate coalescing keeps the invariant that no two free blocks are adjacent
+    BlockHeader* previous = block->previousPhysical;
+    if (previous != nullptr && IsFree(previous)) {
+        RemoveFree(previous);
+        block = Merge(previous, block);
+    }
+    BlockHeader* next = NextPhysical(block);
+    if (IsFree(next)) {
+        RemoveFree(next);
+        block = Merge(block, next);
+    }
+    InsertFree(block);
+}
+
+void TLSFAllocator::Reset() {
+    m_used = 0;
+    m_peak = 0;
+    m_flBitmap = 0;
+    for (std::size_t fl = 0; fl < FL_INDEX_COUNT; ++fl) {
+        m_slBitmap[fl] = 0;
+        for (std::size_t sl = 0; sl < SL_INDEX_COUNT; ++sl) {
+            m_blocks[fl][sl] = nullptr;
+        }
+    }
+
+    // One free block spanning the region, followed by a used zero-sized sentinel
+    BlockHeader* first = (BlockHeader*) m_start_ptr;
+    first->previousPhysical = nullptr;
+    first->size = (m_totalSize - 2 * BLOCK_HEADER_SIZE) & ~(ALIGN_SIZE - 1);
+    BlockHeader* sentinel = NextPhysical(first);
+    sentinel->previousPhysical = first;
+    sentinel->size = 0;
+    InsertFree(first);
+}
+
+void TLSFAllocator::MappingInsert(const std::size_t size, std::size_t& fl, std::size_t& sl) {
+    if (size < SMALL_BLOCK_SIZE) {
+        // Small blocks are linearly spread over the first level
+        fl = 0;
+        sl = size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT);
+    } else {
+        const std::size_t lastBit = Utils::FindLastSet(size);
+        sl = (size >> (lastBit - SL_INDEX_COUNT_LOG2)) ^ SL_INDEX_COUNT;
+        fl = lastBit - (FL_INDEX_SHIFT - 1);
+    }
+}
+
+void TLSFAllocator::MappingSearch(const std::size_t size, std::size_t& fl, std::size_t& sl) {
+    // Round up to the next list so that any block found there is big enough
+    std::size_t roundedSize = size;
+    if (size >= SMALL_BLOCK_SIZE) {
+        roundedSize += ((std::size_t) 1 << (Utils::FindLastSet(size) - SL_INDEX_COUNT_LOG2)) - 1;
+    }
+    MappingInsert(roundedSize, fl, sl);
+}
+
+TLSFAllocator::BlockHeader* TLSFAllocator::FindSuitable(std::size_t& fl, std::size_t& sl) const {
+    if (fl >= FL_INDEX_COUNT) {
+        return nullptr;
+    }
+    uint32_t slMap = m_slBitmap[fl] & (~0u << sl);
+    if (slMap == 0) {
+        // Nothing left in this first level, take the smallest non-empty bigger one
+        const uint64_t flMap = m_flBitmap & (~0ull << (fl + 1));
+        if (flMap == 0) {
+            return nullptr;
+        }
+        fl = Utils::FindFirstSet(flMap);
+        slMap = m_slBitmap[fl];
+    }
+    sl = Utils::FindFirstSet(slMap);
+    return m_blocks[fl][sl];
+}
+
+void TLSFAllocator::InsertFree(BlockHeader* block) {
+    std::size_t fl, sl;
+    MappingInsert(BlockSize(block), fl, sl);
+
+    block->size |= FREE_BIT;
+    block->previousFree = nullptr;
+    block->nextFree = m_blocks[fl][sl];
+    if (block->nextFree != nullptr) {
+        block->nextFree->previousFree = block;
+    }
+    m_blocks[fl][sl] = block;
+    m_flBitmap |= (uint64_t) 1 << fl;
+    m_slBitmap[fl] |= (uint32_t) 1 << sl;
+}
+
+void TLSFAllocator::RemoveFree(BlockHeader* block) {
+    std::size_t fl, sl;
+    MappingInsert(BlockSize(block), fl, sl);
+
+    if (block->previousFree != nullptr) {
+        block->previousFree->nextFree = block->nextFree;
+    } else {
+        m_blocks[fl][sl] = block->nextFree;
+        if (block->nextFree == nullptr) {
+            m_slBitmap[fl] &= ~((uint32_t) 1 << sl);
+            if (m_slBitmap[fl] == 0) {
+                m_flBitmap &= ~((uint64_t) 1 << fl);
+            }
+        }
+    }
+    if (block->nextFree != nullptr) {
+        block->nextFree->previousFree = block->previousFree;
+    }
+}
+
+TLSFAllocator::BlockHeader* TLSFAllocator::Split(BlockHeader* block, const std::size_t size) {
+    BlockHeader* remaining = (BlockHeader*) ((std::size_t) block + BLOCK_HEADER_SIZE + size);
+    remaining->size = BlockSize(block) - size - BLOCK_HEADER_SIZE;
+    remaining->previousPhysical = block;
+    NextPhysical(remaining)->previousPhysical = remaining;
+    block->size = size | (block->size & FREE_BIT);
+    return remaining;
+}
+
+TLSFAllocator::BlockHeader* TLSFAllocator::Merge(BlockHeader* previous, BlockHeader* block) {
+    previous->size += BLOCK_HEADER_SIZE + BlockSize(block);
+    NextPhysical(previous)->previousPhysical = previous;
+#ifdef _DEBUG
+    std::cout << "\tMerging " << (void*) previous << " & " << (void*) block << "\tS " << BlockSize(previous) << std::endl;
+#endif
+    return previous;
+}
@@ -0,0 +1,244 @@
+#include "ThreadCacheAllocator.h"
+#include "ThreadRegistry.h"
+#include <stdlib.h>     /* calloc, free */
+#include <cassert>   /* assert */
+#include <algorithm>    /* max, min */
+#ifdef _DEBUG
+#include <iostream>
+#endif
+
+const std::size_t ThreadCacheAllocator::MIN_SMALL_SIZE;
+const std::size_t ThreadCacheAllocator::MAX_SMALL_SIZE;
+const std::size_t ThreadCacheAllocator::SIZE_CLASSES;
+const std::size_t ThreadCacheAllocator::MAGAZINE_CAPACITY;
+const std::size_t ThreadCacheAllocator::BATCH_SIZE;
+
+ThreadCacheAllocator::ThreadCacheAllocator(const std::size_t totalSize, const std::size_t maxThreads)
+: Allocator(totalSize), m_maxThreads{maxThreads} {
+    // Half of the memory is split evenly between the size classes, the rest backs large requests
+    m_classPoolSize = (totalSize / 2 / SIZE_CLASSES) / MAX_SMALL_SIZE * MAX_SMALL_SIZE;
+    assert(m_classPoolSize >= MAX_SMALL_SIZE && "Total size is too small for the size classes");
+    assert(maxThreads > 0 && "At least one thread is required");
+    for (std::size_t i = 0; i < SIZE_CLASSES; ++i) {
+        m_classes[i].pool = nullptr;
+    }
+}
+
+void ThreadCacheAllocator::Init() {
+    DestroyHeaps();
+
+    for (std::size_t i = 0; i < SIZE_CLASSES; ++i) {
+        m_classes[i].pool = new PoolAllocator(m_classPoolSize, ClassSize(i));
+        m_classes[i].pool->Init();
+    }
+    m_largeHeap = new FreeListAllocator(m_totalSize - SIZE_CLASSES * m_classPoolSize, FreeListAllocator::FIND_FIRST);
+    m_largeHeap->Init();
+
+    // Zeroed memory means every magazine starts empty
+    m_caches = (ThreadCache*) calloc(m_maxThreads, sizeof(ThreadCache));
+    m_used = 0;
+    m_peak = 0;
+}
+
+ThreadCacheAllocator::~ThreadCacheAllocator() {
+    DestroyHeaps();
+}
+
+void ThreadCacheAllocator::DestroyHeaps() {
+    for (std::size_t i = 0; i < SIZE_CLASSES; ++i) {
+        delete m_classes[i].pool;
+        m_classes[i].pool = nullptr;
+    }
+    delete m_largeHeap;
+    m_largeHeap = nullptr;
+    free(m_caches);
+    m_caches = nullptr;
+}
+
+void* ThreadCacheAllocator::Allocate(const std::size_t size, const std::size_t alignment) {
+    if (size <= MAX_SMALL_SIZE && alignment <= MIN_SMALL_SIZE) {
+        const std::size_t sizeClass = SizeClass(size);
+        ThreadCache* cache = CurrentCache();
+        if (cache == nullptr) {
+            return AllocateUncached(sizeClass);
+        }
+        Magazine& magazine = cache->magazines[sizeClass];
+        if (magazine.count == 0) {
+            Refill(sizeClass, magazine);
+            if (magazine.count == 0) {
+                return nullptr;
+            }
+        }
+        return magazine.chunks[--magazine.count];
+    }
+
+    std::size_t usedBefore, usedAfter;
+    void* ptr;
+    {
+        std::lock_guard<std::mutex> lock(m_largeMutex);
+        usedBefore = m_largeHeap->GetUsed();
+        ptr = m_largeHeap->Allocate(std::max(size, MIN_SMALL_SIZE), std::max(alignment, (std::size_t) 8));
+        usedAfter = m_largeHeap->GetUsed();
+    }
+    UpdateUsed(usedAfter - usedBefore, 0);
+    return ptr;
+}
+
+void ThreadCacheAllocator::Free(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    const std::size_t sizeClass = FindClass(ptr);
+    if (sizeClass < SIZE_CLASSES) {
+        ThreadCache* cache = CurrentCache();
+        if (cache == nullptr) {
+            FreeUncached(sizeClass, ptr);
+            return;
+        }
+        Magazine& magazine = cache->magazines[sizeClass];
+        if (magazine.count == MAGAZINE_CAPACITY) {
+            Drain(sizeClass, magazine, BATCH_SIZE);
+        }
+        magazine.chunks[magazine.count++] = ptr;
+        return;
+    }
+
+    std::size_t usedBefore, usedAfter;
+    {
+        std::lock_guard<std::mutex> lock(m_largeMutex);
+        usedBefore = m_largeHeap->GetUsed();
+        m_largeHeap->Free(ptr);
+        usedAfter = m_largeHeap->GetUsed();
+    }
+    UpdateUsed(0, usedBefore - usedAfter);
+}
+
+void ThreadCacheAllocator::Refill(const std::size_t sizeClass, Magazine& magazine) {
+    const std::size_t chunkSize = ClassSize(sizeClass);
+    std::size_t count;
+    {
+        std::lock_guard<std::mutex> lock(m_classes[sizeClass].mutex);
+        PoolAllocator* pool = m_classes[sizeClass].pool;
+        const std::size_t available = (m_classPoolSize - pool->GetUsed()) / chunkSize;
+        count = std::min(BATCH_SIZE, available);
+        for (std::size_t i = 0; i < count; ++i) {
+            magazine.chunks[magazine.count++] = pool->Allocate(chunkSize);
+        }
+    }
+    UpdateUsed(count * chunkSize, 0);
+
+#ifdef _DEBUG
+    std::cout << "R" << "\tC " << chunkSize << "\tN " << count << "\tM " << m_used << std::endl;
+#endif
+}
+
+void ThreadCacheAllocator::Drain(const std::size_t sizeClass, Magazine& magazine, const std::size_t count) {
+    {
+        std::lock_guard<std::mutex> lock(m_classes[sizeClass].mutex);
+        PoolAllocator* pool = m_classes[sizeClass].pool;
+        for (std::size_t i = 0; i < count; ++i) {
+            pool->Free(magazine.chunks[--magazine.count]);
+        }
+    }
+    UpdateUsed(0, count * ClassSize(sizeClass));
+
+#ifdef _DEBUG
+    std::cout << "D" << "\tC " << ClassSize(sizeClass) << "\tN " << count << "\tM " << m_used << std::endl;
+#endif
+}
+
+void* ThreadCacheAllocator::AllocateUncached(const std::size_t sizeClass) {
+    const std::size_t chunkSize = ClassSize(sizeClass);
+    void* ptr = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_classes[sizeClass].mutex);
+        PoolAllocator* pool = m_classes[sizeClass].pool;
+        if (m_classPoolSize - pool->GetUsed() >= chunkSize) {
+            ptr = pool->Allocate(chunkSize);
+        }
+    }
+    if (ptr != nullptr) {
+        UpdateUsed(chunkSize, 0);
+    }
+    return ptr;
+}
+
+void ThreadCacheAllocator::FreeUncached(const std::size_t sizeClass, void* ptr) {
+    {
+        std::lock_guard<std::mutex> lock(m_classes[sizeClass].mutex);
+        m_classes[sizeClass].pool->Free(ptr);
+    }
+    UpdateUsed(0, ClassSize(sizeClass));
+}
+
+void ThreadCacheAllocator::Flush() {
+    ThreadCache* cache = CurrentCache();
+    if (cache == nullptr) {
+        return;
+    }
+    for (std::size_t i = 0; i < SIZE_CLASSES; ++i) {
+        Drain(i, cache->magazines[i], cache->magazines[i].count);
+    }
+}
+
+void ThreadCacheAllocator::Reset() {
+    for (std::size_t t = 0; t < m_maxThreads; ++t) {
+        for (std::size_t i = 0; i < SIZE_CLASSES; ++i) {
+            m_caches[t].magazines[i].count = 0;
+        }
+    }
+    for (std::size_t i = 0; i < SIZE_CLASSES; ++i) {
+        m_classes[i].pool->Reset();
+    }
+    m_largeHeap->Reset();
+    m_used = 0;
+    m_peak = 0;
+}
+
+void ThreadCacheAllocator::LockAll() {
+    ThreadRegistry::Lock();
+    for (std::size_t i = 0; i < SIZE_CLASSES; ++i) {
+        m_classes[i].mutex.lock();
+    }
+    m_largeMutex.lock();
+    m_statsMutex.lock();
+}
+
+void ThreadCacheAllocator::UnlockAll() {
+    m_statsMutex.unlock();
+    m_largeMutex.unlock();
+    for (std::size_t i = SIZE_CLASSES; i > 0; --i) {
+        m_classes[i - 1].mutex.unlock();
+    }
+    ThreadRegistry::Unlock();
+}
+
+void ThreadCacheAllocator::UpdateUsed(const std::size_t allocated, const std::size_t freed) {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_used = m_used + allocated - freed;
+    m_peak = std::max(m_peak, m_used);
+}
+
+std::size_t ThreadCacheAllocator::FindClass(const void* ptr) const {
+    const std::size_t address = (std::size_t) ptr;
+    for (std::size_t i = 0; i < SIZE_CLASSES; ++i) {
+        const std::size_t start = (std::size_t) m_classes[i].pool->GetStartPtr();
+        if (address >= start && address < start + m_classPoolSize) {
+            return i;
+        }
+    }
+    return SIZE_CLASSES;
+}
+
+std::size_t ThreadCacheAllocator::SizeClass(const std::size_t size) {
+    std::size_t sizeClass = 0;
+    while (ClassSize(sizeClass) < size) {
+        ++sizeClass;
+    }
+    return sizeClass;
+}
+
+ThreadCacheAllocator::ThreadCache* ThreadCacheAllocator::CurrentCache() const {
+    const std::size_t index = ThreadRegistry::CurrentIndex();
+    return index < m_maxThreads ? &m_caches[index] : nullptr;
+}
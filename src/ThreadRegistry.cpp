@@ -0,0 +1,43 @@
+#include "ThreadRegistry.h"
+#include <mutex>
+#include <vector>
+
+namespace {
+    std::mutex s_registryMutex;
+    std::vector<std::size_t> s_freeIndices;
+    std::size_t s_nextIndex = 0;
+
+    struct ThreadSlot {
+        std::size_t index;
+
+        ThreadSlot() {
+            std::lock_guard<std::mutex> lock(s_registryMutex);
+            if (!s_freeIndices.empty()) {
+                index = s_freeIndices.back();
+                s_freeIndices.pop_back();
+            } else {
+                // Room for every index ever issued, so that exiting threads never allocate
+                s_freeIndices.reserve(s_nextIndex + 1);
+                index = s_nextIndex++;
+            }
+        }
+
+        ~ThreadSlot() {
+            std::lock_guard<std::mutex> lock(s_registryMutex);
+            s_freeIndices.push_back(index);
+        }
+    };
+}
+
+std::size_t ThreadRegistry::CurrentIndex() {
+    static thread_local ThreadSlot slot;
+    return slot.index;
+}
+
+void ThreadRegistry::Lock() {
+    s_registryMutex.lock();
+}
+
+void ThreadRegistry::Unlock() {
+    s_registryMutex.unlock();
+}
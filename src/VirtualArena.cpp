@@ -0,0 +1,70 @@
+#include "VirtualArena.h"
+#include <algorithm>    /* max, min */
+#ifdef _DEBUG
+#include <iostream>
+#endif
+
+VirtualArena::~VirtualArena() {
+    Release();
+}
+
+void VirtualArena::Allocate(RegionProvider* provider, const std::size_t size) {
+    Release();
+    m_provider = provider;
+    m_size = size;
+    m_reserved = false;
+    m_start_ptr = provider->Allocate(size);
+    m_committed = m_start_ptr != nullptr ? size : 0;
+}
+
+void VirtualArena::Reserve(RegionProvider* provider, const std::size_t size, const std::size_t retainedSize) {
+    Release();
+    m_provider = provider;
+    m_size = size;
+    m_retainedSize = retainedSize;
+    m_reserved = true;
+    m_start_ptr = provider->Reserve(size);
+    m_committed = 0;
+}
+
+void VirtualArena::Release() {
+    if (m_start_ptr != nullptr) {
+        m_provider->Free(m_start_ptr, m_size);
+        m_start_ptr = nullptr;
+    }
+    m_committed = 0;
+}
+
+bool VirtualArena::Commit(const std::size_t end) {
+    if (!m_reserved || end > m_size) {
+        return false;
+    }
+    // Grow geometrically so that a long run of small allocations costs a logarithmic number of calls
+    const std::size_t granularity = m_provider->GetCommitGranularity();
+    std::size_t committed = std::max(end, 2 * m_committed);
+    committed = std::min((committed + granularity - 1) & ~(granularity - 1), m_size);
+    if (!m_provider->Commit((void*) ((std::size_t) m_start_ptr + m_committed), committed - m_committed)) {
+        return false;
+    }
+#ifdef _DEBUG
+    std::cout << "C" << "\t@S " << m_start_ptr << "\tF " << m_committed << "\tT " << committed << std::endl;
+#endif
+    m_committed = committed;
+    return true;
+}
+
+void VirtualArena::Trim() {
+    if (!m_reserved) {
+        return;
+    }
+    const std::size_t granularity = m_provider->GetCommitGranularity();
+    const std::size_t retained = (m_retainedSize + granularity - 1) & ~(granularity - 1);
+    if (m_committed <= retained) {
+        return;
+    }
+#ifdef _DEBUG
+    std::cout << "D" << "\t@S " << m_start_ptr << "\tF " << retained << "\tT " << m_committed << std::endl;
+#endif
+    m_provider->Decommit((void*) ((std::size_t) m_start_ptr + retained), m_committed - retained);
+    m_committed = retained;
+}
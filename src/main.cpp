@@ -2,17 +2,41 @@
 #include <cstddef>
 #include <vector>
 #include <memory>
+#include <thread>
+#include <algorithm>
 
 #include "Benchmark.h"
 #include "Allocator.h"
 #include "StackAllocator.h"
+#include "DoubleEndedStackAllocator.h"
 #include "CAllocator.h"
 #include "LinearAllocator.h"
 #include "PoolAllocator.h"
+#include "BitmapPoolAllocator.h"
 #include "FreeListAllocator.h"
+#include "LockedAllocator.h"
+#include "ThreadCacheAllocator.h"
+#include "SlabAllocator.h"
+#include "TLSFAllocator.h"
+#include "ConcurrentPoolAllocator.h"
+#include "OwnerPoolAllocator.h"
+#include "ShardedAllocator.h"
+#include "RegionProvider.h"
+#include "StaticAllocator.h"
 
-int main()
+int main(int argc, char* argv[])
 {
+    // The backing regions come from the backend given as first argument: malloc (default), mmap, hugetlb or thp
+    if (argc > 1) {
+        RegionProvider::Backend backend;
+        if (!RegionProvider::FromName(argv[1], backend)) {
+            std::cerr << "Unknown region provider " << argv[1] << ", expected malloc, mmap, hugetlb or thp" << std::endl;
+            return 1;
+        }
+        RegionProvider::SetDefault(RegionProvider::Get(backend));
+    }
+    std::cout << "REGION PROVIDER: " << RegionProvider::GetDefault()->GetName() << std::endl;
+
     const std::size_t A = static_cast<std::size_t>(1e9);
     const std::size_t B = static_cast<std::size_t>(1e8);
 
@@ -21,9 +45,25 @@ int main()
 
     std::unique_ptr<Allocator> cAllocator = std::make_unique<CAllocator>();
     std::unique_ptr<Allocator> linearAllocator = std::make_unique<LinearAllocator>(A);
+    std::unique_ptr<Allocator> chainedLinearAllocator = std::make_unique<LinearAllocator>(1 << 20, 1 << 26);
+    std::unique_ptr<LinearAllocator> reservedLinear = std::make_unique<LinearAllocator>(A);
+    reservedLinear->SetReserveMode(1 << 20);
+    std::unique_ptr<Allocator> reservedLinearAllocator = std::move(reservedLinear);
     std::unique_ptr<Allocator> stackAllocator = std::make_unique<StackAllocator>(A);
+    std::unique_ptr<Allocator> doubleEndedStackAllocator = std::make_unique<DoubleEndedStackAllocator>(A);
     std::unique_ptr<Allocator> poolAllocator = std::make_unique<PoolAllocator>(16777216, 4096);
+    std::unique_ptr<Allocator> bitmapPoolAllocator = std::make_unique<BitmapPoolAllocator>(16777216, 4096);
+    std::unique_ptr<Allocator> growingPoolAllocator = std::make_unique<PoolAllocator>(65536, 4096, 65536, 4);
     std::unique_ptr<Allocator> freeListAllocator = std::make_unique<FreeListAllocator>(B, FreeListAllocator::PlacementPolicy::FIND_FIRST);
+    std::unique_ptr<Allocator> binnedFreeListAllocator = std::make_unique<FreeListAllocator>(B, FreeListAllocator::PlacementPolicy::FIND_BINNED);
+    std::unique_ptr<Allocator> lockedFreeListAllocator = std::make_unique<LockedAllocator>(std::make_unique<FreeListAllocator>(B, FreeListAllocator::PlacementPolicy::FIND_FIRST));
+    std::unique_ptr<Allocator> shardedFreeListAllocator = std::make_unique<ShardedAllocator>(B, FreeListAllocator::PlacementPolicy::FIND_FIRST);
+    std::unique_ptr<Allocator> slabAllocator = std::make_unique<SlabAllocator>(B);
+    std::unique_ptr<Allocator> tlsfAllocator = std::make_unique<TLSFAllocator>(B);
+    std::unique_ptr<Allocator> lockedPoolAllocator = std::make_unique<LockedAllocator>(std::make_unique<PoolAllocator>(16777216, 64));
+    std::unique_ptr<Allocator> concurrentPoolAllocator = std::make_unique<ConcurrentPoolAllocator>(16777216, 64);
+    std::unique_ptr<Allocator> threadCacheAllocator = std::make_unique<ThreadCacheAllocator>(B);
+    std::unique_ptr<Allocator> ownerPoolAllocator = std::make_unique<OwnerPoolAllocator>(16777216, 64);
 
     Benchmark benchmark(OPERATIONS);
 
@@ -36,23 +76,161 @@ int main()
     std::cout << "LINEAR" << std::endl;
     benchmark.MultipleAllocation(linearAllocator, ALLOCATION_SIZES, ALIGNMENTS);
     benchmark.RandomAllocation(linearAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.BatchAllocation(linearAllocator, 64, 8, 64);
+    benchmark.Reallocation(linearAllocator, 64, 65536);
+
+    std::cout << "RESERVED LINEAR" << std::endl;
+    benchmark.MultipleAllocation(reservedLinearAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.RandomAllocation(reservedLinearAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+
+    std::cout << "CHAINED LINEAR" << std::endl;
+    benchmark.MultipleAllocation(chainedLinearAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.RandomAllocation(chainedLinearAllocator, ALLOCATION_SIZES, ALIGNMENTS);
 
     std::cout << "STACK" << std::endl;
     benchmark.MultipleAllocation(stackAllocator, ALLOCATION_SIZES, ALIGNMENTS);
     benchmark.MultipleFree(stackAllocator, ALLOCATION_SIZES, ALIGNMENTS);
     benchmark.RandomAllocation(stackAllocator, ALLOCATION_SIZES, ALIGNMENTS);
     benchmark.RandomFree(stackAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.Reallocation(stackAllocator, 64, 65536);
+
+    std::cout << "DOUBLE ENDED STACK" << std::endl;
+    benchmark.MultipleAllocation(doubleEndedStackAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.MultipleFree(doubleEndedStackAllocator, ALLOCATION_SIZES, ALIGNMENTS);
 
     std::cout << "POOL" << std::endl;
     benchmark.SingleAllocation(poolAllocator, 4096, 8);
     benchmark.SingleFree(poolAllocator, 4096, 8);
+    benchmark.BatchAllocation(poolAllocator, 4096, 8, 64);
+    benchmark.BatchFree(poolAllocator, 4096, 8, 64);
+
+    std::cout << "BITMAP POOL" << std::endl;
+    benchmark.SingleAllocation(bitmapPoolAllocator, 4096, 8);
+    benchmark.SingleFree(bitmapPoolAllocator, 4096, 8);
+    benchmark.BatchAllocation(bitmapPoolAllocator, 4096, 8, 64);
+    benchmark.BatchFree(bitmapPoolAllocator, 4096, 8, 64);
+
+    std::cout << "GROWING POOL" << std::endl;
+    benchmark.SingleAllocation(growingPoolAllocator, 4096, 8);
+    benchmark.SingleFree(growingPoolAllocator, 4096, 8);
+    benchmark.BatchFree(growingPoolAllocator, 4096, 8, 64);
 
     std::cout << "FREE LIST" << std::endl;
     benchmark.MultipleAllocation(freeListAllocator, ALLOCATION_SIZES, ALIGNMENTS);
     benchmark.MultipleFree(freeListAllocator, ALLOCATION_SIZES, ALIGNMENTS);
     benchmark.RandomAllocation(freeListAllocator, ALLOCATION_SIZES, ALIGNMENTS);
     benchmark.RandomFree(freeListAllocator, ALLOCATION_SIZES, ALIGNMENTS);
-    
+    benchmark.RandomChurn(freeListAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.Reallocation(freeListAllocator, 64, 65536);
+
+    std::cout << "BINNED FREE LIST" << std::endl;
+    benchmark.MultipleAllocation(binnedFreeListAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.MultipleFree(binnedFreeListAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.RandomAllocation(binnedFreeListAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.RandomFree(binnedFreeListAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.RandomChurn(binnedFreeListAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+
+    std::cout << "TLSF" << std::endl;
+    benchmark.MultipleAllocation(tlsfAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.MultipleFree(tlsfAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.RandomAllocation(tlsfAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.RandomFree(tlsfAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.RandomChurn(tlsfAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+
+    std::cout << "SLAB" << std::endl;
+    benchmark.MultipleAllocation(slabAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.MultipleFree(slabAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.RandomAllocation(slabAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.RandomFree(slabAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+
+    std::cout << "THREAD CACHE" << std::endl;
+    benchmark.MultipleAllocation(threadCacheAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.MultipleFree(threadCacheAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.RandomAllocation(threadCacheAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+    benchmark.RandomFree(threadCacheAllocator, ALLOCATION_SIZES, ALIGNMENTS);
+
+    // Memory cost of small objects with and without a per-allocation header
+    std::unique_ptr<FreeListAllocator> headerlessFreeList = std::make_unique<FreeListAllocator>(B, FreeListAllocator::PlacementPolicy::FIND_FIRST);
+    headerlessFreeList->SetHeaderlessMode();
+    std::unique_ptr<Allocator> headerlessFreeListAllocator = std::move(headerlessFreeList);
+    for (const std::size_t size : {24, 48}) {
+        std::cout << "SMALL OBJECTS FREE LIST" << std::endl;
+        benchmark.SmallObjects(freeListAllocator, size, 100000);
+        std::cout << "SMALL OBJECTS HEADERLESS FREE LIST" << std::endl;
+        benchmark.SmallObjects(headerlessFreeListAllocator, size, 100000);
+        std::cout << "SMALL OBJECTS STACK" << std::endl;
+        benchmark.SmallObjects(stackAllocator, size, 100000);
+        std::cout << "SMALL OBJECTS SLAB" << std::endl;
+        benchmark.SmallObjects(slabAllocator, size, 100000);
+    }
+
+    // The same workloads through virtual calls and through StaticAllocator, where they are resolved at compile time
+    StaticAllocator<LinearStorage> staticLinearAllocator(A);
+    StaticAllocator<PoolStorage<4096>> staticPoolAllocator(16777216);
+    StaticAllocator<PoolStorage<4096>, 8, MutexLock, TrackStats> lockedStaticPoolAllocator(16777216);
+    StaticAllocator<FreeListStorage<FreeListAllocator::FIND_FIRST>> staticFreeListAllocator(B);
+    std::cout << "VIRTUAL LINEAR" << std::endl;
+    benchmark.SingleAllocation(linearAllocator, 64, 8);
+    std::cout << "STATIC LINEAR" << std::endl;
+    benchmark.StaticSingleAllocation(staticLinearAllocator, 64);
+    std::cout << "VIRTUAL POOL" << std::endl;
+    benchmark.SingleFree(poolAllocator, 4096, 8);
+    std::cout << "STATIC POOL" << std::endl;
+    benchmark.StaticSingleFree(staticPoolAllocator, 4096);
+    std::cout << "STATIC LOCKED POOL WITH STATS" << std::endl;
+    benchmark.StaticSingleFree(lockedStaticPoolAllocator, 4096);
+    std::cout << "VIRTUAL FREE LIST" << std::endl;
+    benchmark.SingleFree(freeListAllocator, 64, 8);
+    std::cout << "STATIC FREE LIST" << std::endl;
+    benchmark.StaticSingleFree(staticFreeListAllocator, 64);
+
+    // The same container workloads on the default resource and on the allocators that serve any size
+    std::unique_ptr<Allocator> defaultResource;
+    std::cout << "CONTAINERS DEFAULT" << std::endl;
+    benchmark.Containers(defaultResource);
+    std::cout << "CONTAINERS LINEAR" << std::endl;
+    benchmark.Containers(linearAllocator);
+    std::cout << "CONTAINERS FREE LIST" << std::endl;
+    benchmark.Containers(freeListAllocator);
+    std::cout << "CONTAINERS TLSF" << std::endl;
+    benchmark.Containers(tlsfAllocator);
+    std::cout << "CONTAINERS THREAD CACHE" << std::endl;
+    benchmark.Containers(threadCacheAllocator);
+
+    const std::vector<std::size_t> POOL_SIZES {64};
+    const std::vector<std::size_t> POOL_ALIGNMENTS {8};
+
+    // Producer/consumer: every block is freed by another thread than the one that allocated it
+    std::cout << "CROSS THREAD LOCKED POOL" << std::endl;
+    benchmark.CrossThreadFree(lockedPoolAllocator, 64, 8);
+    std::cout << "CROSS THREAD CONCURRENT POOL" << std::endl;
+    benchmark.CrossThreadFree(concurrentPoolAllocator, 64, 8);
+    std::cout << "CROSS THREAD THREAD CACHE" << std::endl;
+    benchmark.CrossThreadFree(threadCacheAllocator, 64, 8);
+    std::cout << "CROSS THREAD OWNER POOL" << std::endl;
+    benchmark.CrossThreadFree(ownerPoolAllocator, 64, 8);
+
+    const unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+        std::cout << "LOCKED POOL x" << nThreads << std::endl;
+        benchmark.MultiThreadedRandomFree(lockedPoolAllocator, POOL_SIZES, POOL_ALIGNMENTS, nThreads);
+
+        std::cout << "CONCURRENT POOL x" << nThreads << std::endl;
+        benchmark.MultiThreadedRandomFree(concurrentPoolAllocator, POOL_SIZES, POOL_ALIGNMENTS, nThreads);
+
+        std::cout << "LOCKED FREE LIST x" << nThreads << std::endl;
+        benchmark.MultiThreadedRandomFree(lockedFreeListAllocator, ALLOCATION_SIZES, ALIGNMENTS, nThreads);
+
+        std::cout << "SHARDED FREE LIST x" << nThreads << std::endl;
+        benchmark.MultiThreadedRandomFree(shardedFreeListAllocator, ALLOCATION_SIZES, ALIGNMENTS, nThreads);
+
+        std::cout << "THREAD CACHE x" << nThreads << std::endl;
+        benchmark.MultiThreadedRandomFree(threadCacheAllocator, ALLOCATION_SIZES, ALIGNMENTS, nThreads);
+
+        std::cout << "OWNER POOL x" << nThreads << std::endl;
+        benchmark.MultiThreadedRandomFree(ownerPoolAllocator, POOL_SIZES, POOL_ALIGNMENTS, nThreads);
+    }
+
     return 0;
 }
 
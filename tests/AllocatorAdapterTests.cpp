@@ -0,0 +1,121 @@
+#include "AllocatorResource.h"
+#include "StlAllocator.h"
+#include "FreeListAllocator.h"
+#include "LinearAllocator.h"
+#include "TLSFAllocator.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+// Records the sizes given to FreeSized
+class SizeRecordingAllocator : public TLSFAllocator {
+public:
+    std::vector<std::size_t> freedSizes;
+
+    SizeRecordingAllocator(const std::size_t totalSize) : TLSFAllocator(totalSize) {}
+
+    virtual void FreeSized(void* ptr, const std::size_t size) override {
+        freedSizes.push_back(size);
+        TLSFAllocator::FreeSized(ptr, size);
+    }
+};
+}
+
+TEST(AllocatorAdapterTests, PmrContainersUseTheAllocator) {
+    FreeListAllocator allocator(1 << 20, FreeListAllocator::FIND_BEST);
+    allocator.Init();
+    AllocatorResource resource(&allocator);
+
+    {
+        std::pmr::vector<int> values(&resource);
+        for (int i = 0; i < 1000; ++i) {
+            values.push_back(i);
+        }
+        std::pmr::unordered_map<int, std::pmr::string> map(&resource);
+        for (int i = 0; i < 100; ++i) {
+            map.emplace(i, std::pmr::string(100, 'x'));
+        }
+        ASSERT_GT(allocator.GetUsed(), 1000 * sizeof(int) + 100 * 100);
+        ASSERT_EQ(map[42].size(), 100u);
+    }
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+}
+
+TEST(AllocatorAdapterTests, ResourceForwardsSizeAndAlignment) {
+    SizeRecordingAllocator allocator(1 << 20);
+    allocator.Init();
+    AllocatorResource resource(&allocator);
+
+    void* ptr = resource.allocate(100, 64);
+    ASSERT_EQ(reinterpret_cast<std::size_t>(ptr) % 64, 0u);
+    resource.deallocate(ptr, 100, 64);
+    ASSERT_EQ(allocator.freedSizes, std::vector<std::size_t>{100});
+}
+
+TEST(AllocatorAdapterTests, ResourceThrowsWhenExhausted) {
+    TLSFAllocator allocator(4096);
+    allocator.Init();
+    AllocatorResource resource(&allocator);
+
+    ASSERT_THROW((void) resource.allocate(1 << 20, 8), std::bad_alloc);
+
+    FreeListAllocator freeList(4096, FreeListAllocator::FIND_FIRST);
+    freeList.Init();
+    AllocatorResource freeListResource(&freeList);
+    ASSERT_THROW((void) freeListResource.allocate(1 << 20, 8), std::bad_alloc);
+}
+
+TEST(AllocatorAdapterTests, ResourceEquality) {
+    FreeListAllocator first(4096, FreeListAllocator::FIND_FIRST);
+    FreeListAllocator second(4096, FreeListAllocator::FIND_FIRST);
+    AllocatorResource a(&first), b(&first), c(&second);
+
+    ASSERT_TRUE(a == b);
+    ASSERT_FALSE(a == c);
+    ASSERT_FALSE(a == *std::pmr::new_delete_resource());
+}
+
+TEST(AllocatorAdapterTests, LinearDeallocationsAreIgnored) {
+    LinearAllocator allocator(1 << 20);
+    allocator.Init();
+    AllocatorResource resource(&allocator);
+
+    std::pmr::vector<int> values(&resource);
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i);
+    }
+    values.clear();
+    values.shrink_to_fit();
+    ASSERT_GT(allocator.GetUsed(), 0u);
+}
+
+TEST(AllocatorAdapterTests, StlAllocatorWithContainers) {
+    SizeRecordingAllocator allocator(1 << 20);
+    allocator.Init();
+
+    {
+        StlAllocator<int> stlAllocator(&allocator);
+        std::vector<int, StlAllocator<int>> values(stlAllocator);
+        values.reserve(10);
+        for (int i = 0; i < 10; ++i) {
+            values.push_back(i);
+        }
+
+        // Node containers rebind the allocator to their node type
+        std::map<int, int, std::less<int>, StlAllocator<std::pair<const int, int>>> map(stlAllocator);
+        for (int i = 0; i < 100; ++i) {
+            map[i] = i;
+        }
+        ASSERT_EQ(map.size(), 100u);
+        ASSERT_TRUE(StlAllocator<double>(stlAllocator) == stlAllocator);
+    }
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+    // The vector buffer and the 100 map nodes were freed with their sizes
+    ASSERT_EQ(allocator.freedSizes.size(), 101u);
+    ASSERT_NE(std::find(allocator.freedSizes.begin(), allocator.freedSizes.end(), 10 * sizeof(int)), allocator.freedSizes.end());
+}
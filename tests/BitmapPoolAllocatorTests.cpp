@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "BitmapPoolAllocator.h"
+#include <cstring>
+#include <vector>
+
+TEST(BitmapPoolAllocatorTests, AllocatesLowestFreeChunk) {
+    BitmapPoolAllocator allocator(64 * 16, 64);
+    allocator.Init();
+    char* start = (char*) allocator.GetStartPtr();
+
+    void* ptrs[4];
+    for (int i = 0; i < 4; ++i) {
+        ptrs[i] = allocator.Allocate(64, 8);
+        ASSERT_EQ(ptrs[i], start + 64 * i);
+    }
+    // Address order, not LIFO
+    allocator.Free(ptrs[2]);
+    allocator.Free(ptrs[1]);
+    ASSERT_EQ(allocator.Allocate(64, 8), ptrs[1]);
+    ASSERT_EQ(allocator.Allocate(64, 8), ptrs[2]);
+    ASSERT_EQ(allocator.GetUsed(), 4u * 64);
+}
+
+TEST(BitmapPoolAllocatorTests, FullPoolReturnsNull) {
+    BitmapPoolAllocator allocator(64 * 100, 64);
+    allocator.Init();
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 100; ++i) {
+        ptrs.push_back(allocator.Allocate(64, 8));
+        ASSERT_NE(ptrs.back(), nullptr);
+    }
+    ASSERT_EQ(allocator.Allocate(64, 8), nullptr);
+    ASSERT_EQ(allocator.GetUsed(), 100u * 64);
+
+    allocator.Free(ptrs[42]);
+    ASSERT_EQ(allocator.Allocate(64, 8), ptrs[42]);
+    ASSERT_EQ(allocator.Allocate(64, 8), nullptr);
+}
+
+TEST(BitmapPoolAllocatorTests, FreeChunksAreNotWritten) {
+    BitmapPoolAllocator allocator(32 * 200, 32);
+    allocator.Init();
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 200; ++i) {
+        ptrs.push_back(allocator.Allocate(32, 8));
+        memset(ptrs.back(), 0x5A, 32);
+    }
+    for (void* ptr : ptrs) {
+        allocator.Free(ptr);
+    }
+    allocator.Reset();
+    for (void* ptr : ptrs) {
+        for (int i = 0; i < 32; ++i) {
+            ASSERT_EQ(((unsigned char*) ptr)[i], 0x5A);
+        }
+    }
+}
+
+TEST(BitmapPoolAllocatorTests, FindsFreeChunkPastManyFullWords) {
+    // More than a few AVX2 blocks of full words before the only free chunk
+    const std::size_t nChunks = 64 * 40 + 3;
+    BitmapPoolAllocator allocator(16 * nChunks, 16);
+    allocator.Init();
+
+    std::vector<void*> ptrs;
+    for (std::size_t i = 0; i < nChunks; ++i) {
+        ptrs.push_back(allocator.Allocate(16, 8));
+        ASSERT_NE(ptrs.back(), nullptr);
+    }
+    allocator.Free(ptrs[nChunks - 2]);
+    ASSERT_EQ(allocator.Allocate(16, 8), ptrs[nChunks - 2]);
+
+    void* more[4];
+    ASSERT_EQ(allocator.AllocateBatch(16, 4, more, 8), 0u);
+}
+
+TEST(BitmapPoolAllocatorTests, FreeRangeReleasesOnlyAllocatedChunks) {
+    BitmapPoolAllocator allocator(8 * 300, 8);
+    allocator.Init();
+    char* start = (char*) allocator.GetStartPtr();
+
+    std::vector<void*> ptrs(300);
+    ASSERT_EQ(allocator.AllocateBatch(8, 300, ptrs.data(), 8), 300u);
+    allocator.Free(ptrs[100]);
+
+    // Chunks 50 to 249 across word boundaries, one of them already free
+    allocator.FreeRange(start + 8 * 50, 8 * 200);
+    ASSERT_EQ(allocator.GetUsed(), 8u * 100);
+    ASSERT_TRUE(allocator.IsAllocated(ptrs[49]));
+    ASSERT_FALSE(allocator.IsAllocated(ptrs[50]));
+    ASSERT_FALSE(allocator.IsAllocated(ptrs[249]));
+    ASSERT_TRUE(allocator.IsAllocated(ptrs[250]));
+    ASSERT_EQ(allocator.Allocate(8, 8), ptrs[50]);
+}
+
+TEST(BitmapPoolAllocatorTests, ForEachAllocatedInAddressOrder) {
+    BitmapPoolAllocator allocator(16 * 130, 16);
+    allocator.Init();
+
+    std::vector<void*> ptrs(130);
+    allocator.AllocateBatch(16, 130, ptrs.data(), 8);
+    std::vector<void*> expected;
+    for (std::size_t i = 0; i < ptrs.size(); ++i) {
+        if (i % 3 == 0) {
+            allocator.Free(ptrs[i]);
+        } else {
+            expected.push_back(ptrs[i]);
+        }
+    }
+
+    std::vector<void*> visited;
+    allocator.ForEachAllocated([&visited](void* chunk) { visited.push_back(chunk); });
+    ASSERT_EQ(visited, expected);
+}
+
+TEST(BitmapPoolAllocatorTests, ReleaseFreePagesKeepsUsedPages) {
+    const std::size_t pageSize = RegionProvider::GetPageSize();
+    BitmapPoolAllocator allocator(pageSize * 8, 256);
+    allocator.SetRegionProvider(RegionProvider::Get(RegionProvider::MMAP));
+    allocator.Init();
+
+    char* used = (char*) allocator.Allocate(256, 8);
+    memset(used, 0x7F, 256);
+    ASSERT_EQ(allocator.ReleaseFreePages(), pageSize * 7);
+    ASSERT_EQ((unsigned char) used[255], 0x7F);
+
+    // Released pages are usable again
+    std::vector<void*> ptrs(pageSize * 8 / 256 - 1);
+    ASSERT_EQ(allocator.AllocateBatch(256, ptrs.size(), ptrs.data(), 8), ptrs.size());
+    memset(ptrs.back(), 0, 256);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "ConcurrentPoolAllocator.h"
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST(ConcurrentPoolAllocatorTests, AllocateAndFree) {
+    ConcurrentPoolAllocator allocator(1024, 16);
+    allocator.Init();
+
+    void* ptr1 = allocator.Allocate(16, 8);
+    ASSERT_NE(ptr1, nullptr);
+
+    void* ptr2 = allocator.Allocate(16, 8);
+    ASSERT_NE(ptr2, nullptr);
+    ASSERT_NE(ptr1, ptr2);
+    ASSERT_EQ(allocator.GetUsed(), 32);
+
+    allocator.Free(ptr1);
+    allocator.Free(ptr2);
+    ASSERT_EQ(allocator.GetUsed(), 0);
+    ASSERT_EQ(allocator.GetPeak(), 32);
+}
+
+TEST(ConcurrentPoolAllocatorTests, ReturnsNullptrWhenFull) {
+    ConcurrentPoolAllocator allocator(64, 16);
+    allocator.Init();
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_NE(allocator.Allocate(16, 8), nullptr);
+    }
+    ASSERT_EQ(allocator.Allocate(16, 8), nullptr);
+}
+
+TEST(ConcurrentPoolAllocatorTests, Batch) {
+    ConcurrentPoolAllocator allocator(1024, 16);
+    allocator.Init();
+
+    void* ptrs[64];
+    ASSERT_EQ(allocator.AllocateBatch(16, 40, ptrs), 40u);
+    ASSERT_EQ(allocator.AllocateBatch(16, 40, ptrs + 40), 24u);
+    ASSERT_EQ(std::set<void*>(ptrs, ptrs + 64).size(), 64u);
+    ASSERT_EQ(allocator.Allocate(16, 8), nullptr);
+
+    allocator.FreeBatch(ptrs, 64);
+    ASSERT_EQ(allocator.GetUsed(), 0);
+    ASSERT_EQ(allocator.AllocateBatch(16, 64, ptrs), 64u);
+}
+
+TEST(ConcurrentPoolAllocatorTests, MultiThreadedStress) {
+    const std::size_t chunkSize = 64;
+    const std::size_t nChunks = 4096;
+    ConcurrentPoolAllocator allocator(chunkSize * nChunks, chunkSize);
+    allocator.Init();
+
+    const unsigned int nThreads = 8;
+    std::vector<std::thread> threads;
+    std::vector<int> failures(nThreads, 0);
+    for (unsigned int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&allocator, &failures, t, chunkSize]() {
+            std::vector<void*> ptrs;
+            for (int round = 0; round < 2000; ++round) {
+                const std::size_t count = 1 + (round * 7 + t) % 32;
+                if (round % 2 == 0) {
+                    for (std::size_t i = 0; i < count; ++i) {
+                        void* ptr = allocator.Allocate(chunkSize, 8);
+                        if (ptr != nullptr) {
+                            ptrs.push_back(ptr);
+                        }
+                    }
+                } else {
+                    ptrs.resize(ptrs.size() + count);
+                    ptrs.resize(ptrs.size() - count + allocator.AllocateBatch(chunkSize, count, ptrs.data() + ptrs.size() - count));
+                }
+                // A chunk owned by this thread must not be handed to anybody else
+                for (void* ptr : ptrs) {
+                    std::memset(ptr, (int) t, chunkSize);
+                }
+                for (void* ptr : ptrs) {
+                    if (static_cast<unsigned char*>(ptr)[chunkSize - 1] != t) {
+                        ++failures[t];
+                    }
+                }
+                if (round % 3 == 0) {
+                    allocator.FreeBatch(ptrs.data(), ptrs.size());
+                } else {
+                    for (void* ptr : ptrs) {
+                        allocator.Free(ptr);
+                    }
+                }
+                ptrs.clear();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (unsigned int t = 0; t < nThreads; ++t) {
+        ASSERT_EQ(failures[t], 0);
+    }
+    ASSERT_EQ(allocator.GetUsed(), 0);
+
+    // Every chunk made it back exactly once
+    std::set<void*> chunks;
+    for (std::size_t i = 0; i < nChunks; ++i) {
+        void* ptr = allocator.Allocate(chunkSize, 8);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_TRUE(chunks.insert(ptr).second);
+    }
+    ASSERT_EQ(allocator.Allocate(chunkSize, 8), nullptr);
+}
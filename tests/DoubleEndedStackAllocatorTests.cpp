@@ -0,0 +1,98 @@
+#include "DoubleEndedStackAllocator.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+TEST(DoubleEndedStackAllocatorTests, EndsGrowTowardsEachOther) {
+    DoubleEndedStackAllocator allocator(1024);
+    allocator.Init();
+
+    char* bottom = static_cast<char*>(allocator.AllocateBottom(100, 8));
+    char* top = static_cast<char*>(allocator.AllocateTop(100, 8));
+    ASSERT_NE(bottom, nullptr);
+    ASSERT_NE(top, nullptr);
+    ASSERT_LT(bottom, top);
+    ASSERT_EQ(reinterpret_cast<std::size_t>(bottom) % 8, 0u);
+    ASSERT_EQ(reinterpret_cast<std::size_t>(top) % 8, 0u);
+    ASSERT_LE(top + 100, static_cast<char*>(allocator.GetStartPtr()) + 1024);
+    memset(bottom, 1, 100);
+    memset(top, 2, 100);
+    ASSERT_EQ(allocator.GetUsed(), 1024 - allocator.GetFreeSize());
+}
+
+TEST(DoubleEndedStackAllocatorTests, FailsOnlyWhenEndsMeet) {
+    DoubleEndedStackAllocator allocator(4096);
+    allocator.Init();
+
+    // Either end can use almost all the region
+    void* big = allocator.AllocateTop(4000, 8);
+    ASSERT_NE(big, nullptr);
+    allocator.FreeTop(big);
+    big = allocator.AllocateBottom(4000, 8);
+    ASSERT_NE(big, nullptr);
+    allocator.FreeBottom(big);
+
+    std::size_t allocations = 0;
+    while (true) {
+        void* ptr = allocations % 2 == 0 ? allocator.AllocateBottom(56, 8) : allocator.AllocateTop(56, 8);
+        if (ptr == nullptr) {
+            break;
+        }
+        ++allocations;
+    }
+    ASSERT_EQ(allocations, 4096u / 64);
+    ASSERT_LT(allocator.GetFreeSize(), 64u);
+}
+
+TEST(DoubleEndedStackAllocatorTests, LifoFreeOnEachEnd) {
+    DoubleEndedStackAllocator allocator(4096);
+    allocator.Init();
+
+    std::vector<void*> bottom, top;
+    for (int i = 0; i < 10; ++i) {
+        bottom.push_back(allocator.AllocateBottom(16 + i, 16));
+        top.push_back(allocator.AllocateTop(16 + i, 32));
+        ASSERT_EQ(reinterpret_cast<std::size_t>(top.back()) % 32, 0u);
+    }
+    // Interleaved frees, each end in its own LIFO order, through the generic Free
+    for (int i = 9; i >= 0; --i) {
+        allocator.Free(top[i]);
+        allocator.Free(bottom[i]);
+    }
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+    ASSERT_EQ(allocator.GetFreeSize(), 4096u);
+}
+
+TEST(DoubleEndedStackAllocatorTests, IndependentMarkers) {
+    DoubleEndedStackAllocator allocator(4096);
+    allocator.Init();
+
+    void* level = allocator.AllocateBottom(512, 16);
+    const DoubleEndedStackAllocator::Marker bottomMarker = allocator.GetBottomMarker();
+    const DoubleEndedStackAllocator::Marker topMarker = allocator.GetTopMarker();
+
+    for (int frame = 0; frame < 100; ++frame) {
+        for (int i = 0; i < 20; ++i) {
+            ASSERT_NE(allocator.AllocateTop(64, 16), nullptr);
+        }
+        allocator.FreeToTopMarker(topMarker);
+    }
+    void* scratch = allocator.AllocateBottom(64, 16);
+    ASSERT_NE(scratch, nullptr);
+    allocator.FreeToBottomMarker(bottomMarker);
+    ASSERT_EQ(allocator.AllocateBottom(64, 16), scratch);
+
+    allocator.ResetTop();
+    allocator.ResetBottom();
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+    ASSERT_EQ(allocator.AllocateBottom(512, 16), level);
+}
+
+TEST(DoubleEndedStackAllocatorTests, FreeTopOutOfOrder) {
+    DoubleEndedStackAllocator allocator(1024);
+    allocator.Init();
+
+    void* first = allocator.AllocateTop(32, 8);
+    allocator.AllocateTop(32, 8);
+    ASSERT_DEATH(allocator.FreeTop(first), "Only the last allocation of the top end can be freed");
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "FixedPool.h"
+#include <cstdint>
+#include <set>
+
+// Indices stay 16-bit below 65535 chunks and the stride only grows to hold one
+static_assert(sizeof(FixedPool<4, 1000>::Index) == 2, "");
+static_assert(sizeof(FixedPool<4, 100000>::Index) == 4, "");
+static_assert(FixedPool<4, 1000>::CHUNK_STRIDE == 4, "");
+static_assert(FixedPool<1, 1000>::CHUNK_STRIDE == 2, "");
+static_assert(FixedPool<6, 1000>::CHUNK_STRIDE == 6, "");
+static_assert(FixedPool<24, 1000>::CHUNK_STRIDE == 24, "");
+static_assert(FixedPool<24, 1000, 32>::CHUNK_STRIDE == 32, "");
+static_assert(sizeof(FixedPool<4, 1024>) == 4096 + 3 * sizeof(uint16_t) + 2, "");
+
+// Constant-initializable, so a global pool costs nothing at startup
+constexpr FixedPool<8, 16> CONSTANT_POOL;
+
+static FixedPool<4, 1024> g_pool;
+
+TEST(FixedPoolTests, TinyChunksArePacked) {
+    FixedPool<4, 64> pool;
+    char* first = (char*) pool.Allocate();
+    char* second = (char*) pool.Allocate();
+    ASSERT_NE(first, nullptr);
+    ASSERT_EQ(second, first + 4);
+    ASSERT_EQ(pool.GetUsed(), 8u);
+
+    pool.Free(first);
+    pool.Free(second);
+    ASSERT_EQ(pool.GetUsed(), 0u);
+}
+
+TEST(FixedPoolTests, ReusesLastFreedChunk) {
+    FixedPool<8, 16> pool;
+    void* ptr1 = pool.Allocate();
+    void* ptr2 = pool.Allocate();
+    pool.Free(ptr1);
+    pool.Free(ptr2);
+    ASSERT_EQ(pool.Allocate(), ptr2);
+    ASSERT_EQ(pool.Allocate(), ptr1);
+}
+
+TEST(FixedPoolTests, ExhaustsAtCapacity) {
+    FixedPool<2, 100> pool;
+    std::set<void*> chunks;
+    for (std::size_t i = 0; i < pool.CAPACITY; ++i) {
+        void* ptr = pool.Allocate();
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_TRUE(pool.Owns(ptr));
+        chunks.insert(ptr);
+    }
+    ASSERT_EQ(chunks.size(), pool.CAPACITY);
+    ASSERT_EQ(pool.GetFreeCount(), 0u);
+    ASSERT_EQ(pool.Allocate(), nullptr);
+
+    // Free in scattered order and take everything again
+    for (void* ptr : chunks) {
+        pool.Free(ptr);
+    }
+    std::set<void*> again;
+    for (std::size_t i = 0; i < pool.CAPACITY; ++i) {
+        again.insert(pool.Allocate());
+    }
+    ASSERT_EQ(again, chunks);
+}
+
+TEST(FixedPoolTests, ChunksKeepTheAlignment) {
+    FixedPool<24, 10, 64> pool;
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(pool.Allocate()) % 64, 0u);
+    }
+}
+
+TEST(FixedPoolTests, ResetReturnsEveryChunk) {
+    FixedPool<16, 4> pool;
+    void* first = pool.Allocate();
+    for (int i = 0; i < 3; ++i) {
+        pool.Allocate();
+    }
+    pool.Reset();
+    ASSERT_EQ(pool.GetFreeCount(), 4u);
+    ASSERT_EQ(pool.Allocate(), first);
+}
+
+TEST(FixedPoolTests, GlobalPoolIsReadyWithoutInit) {
+    ASSERT_EQ(CONSTANT_POOL.GetFreeCount(), 16u);
+    int* value = (int*) g_pool.Allocate();
+    ASSERT_NE(value, nullptr);
+    *value = 42;
+    ASSERT_TRUE(g_pool.Owns(value));
+    g_pool.Free(value);
+    ASSERT_EQ(g_pool.GetUsed(), 0u);
+}
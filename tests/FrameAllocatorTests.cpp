@@ -0,0 +1,93 @@
+#include "FrameAllocator.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+TEST(FrameAllocatorTests, DataSurvivesPipelineDepth) {
+    const std::size_t nFrames = 3;
+    FrameAllocator allocator(4096, nFrames);
+    allocator.Init();
+
+    std::vector<int*> produced;
+    for (int frame = 0; frame < 20; ++frame) {
+        int* data = static_cast<int*>(allocator.Allocate(64 * sizeof(int), alignof(int)));
+        ASSERT_NE(data, nullptr);
+        for (int i = 0; i < 64; ++i) {
+            data[i] = frame;
+        }
+        produced.push_back(data);
+
+        // Everything produced in the last nFrames frames is still intact
+        for (std::size_t age = 0; age < nFrames && age < produced.size(); ++age) {
+            const int* old = produced[produced.size() - 1 - age];
+            for (int i = 0; i < 64; ++i) {
+                ASSERT_EQ(old[i], frame - static_cast<int>(age));
+            }
+        }
+        allocator.NextFrame();
+    }
+}
+
+TEST(FrameAllocatorTests, NextFrameResetsOnlyTheOldestFrame) {
+    FrameAllocator allocator(1024, 2);
+    allocator.Init();
+
+    void* first = allocator.Allocate(100, 8);
+    allocator.NextFrame();
+    void* second = allocator.Allocate(100, 8);
+    ASSERT_NE(first, second);
+    ASSERT_EQ(allocator.GetUsed(), 200u);
+
+    // Back to the first frame, which is now two frames old
+    allocator.NextFrame();
+    ASSERT_EQ(allocator.GetCurrentFrame(), 0u);
+    ASSERT_EQ(allocator.GetUsed(), 100u);
+    ASSERT_EQ(allocator.Allocate(100, 8), first);
+    ASSERT_EQ(allocator.GetPeak(), 200u);
+}
+
+TEST(FrameAllocatorTests, FrameRunsOutOfMemory) {
+    FrameAllocator allocator(256, 2);
+    allocator.Init();
+
+    ASSERT_NE(allocator.Allocate(200), nullptr);
+    ASSERT_EQ(allocator.Allocate(200), nullptr);
+    allocator.NextFrame();
+    ASSERT_NE(allocator.Allocate(200), nullptr);
+}
+
+TEST(FrameAllocatorTests, GrowingFrames) {
+    FrameAllocator allocator(256, 2, 4096);
+    allocator.Init();
+
+    for (int frame = 0; frame < 5; ++frame) {
+        for (int i = 0; i < 50; ++i) {
+            ASSERT_NE(allocator.Allocate(100, 8), nullptr);
+        }
+        allocator.NextFrame();
+    }
+    allocator.Reset();
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+}
+
+TEST(FrameAllocatorTests, GrowingFramesKeepAlignment) {
+    FrameAllocator allocator(256, 2, 4096);
+    allocator.Init();
+
+    for (int frame = 0; frame < 3; ++frame) {
+        for (int i = 0; i < 20; ++i) {
+            void* ptr = allocator.Allocate(100, 64);
+            ASSERT_NE(ptr, nullptr);
+            ASSERT_EQ(reinterpret_cast<std::size_t>(ptr) % 64, 0u);
+        }
+        allocator.NextFrame();
+    }
+}
+
+TEST(FrameAllocatorTests, FreeNotAllowed) {
+    FrameAllocator allocator(1024);
+    allocator.Init();
+
+    void* ptr = allocator.Allocate(16, 8);
+    ASSERT_DEATH(allocator.Free(ptr), "Use NextFrame\\(\\) method");
+}
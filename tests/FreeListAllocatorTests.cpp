@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 #include "FreeListAllocator.h"
+#include "LockedAllocator.h"
+#include <cstring>
+#include <vector>
 
 TEST(FreeListAllocator, AllocateAndFree) {
     FreeListAllocator allocator(1024, FreeListAllocator::FIND_FIRST);
@@ -88,3 +91,314 @@ TEST(FreeListAllocator, Reset) {
 
     allocator.Free(ptr3);
 }
+
+TEST(FreeListAllocator, CoalescenceWithBothNeighbours) {
+    FreeListAllocator allocator(1024, FreeListAllocator::FIND_FIRST);
+    allocator.Init();
+
+    void* ptr1 = allocator.Allocate(100, 8);
+    void* ptr2 = allocator.Allocate(100, 8);
+    void* ptr3 = allocator.Allocate(100, 8);
+    void* ptr4 = allocator.Allocate(100, 8);
+    allocator.Free(ptr1);
+    allocator.Free(ptr3);
+    allocator.Free(ptr2);
+    ASSERT_EQ(allocator.GetUsed(), 120);
+
+    // ptr1, ptr2 and ptr3 were merged into one block in front of ptr4
+    void* ptr5 = allocator.Allocate(300, 8);
+    ASSERT_EQ(ptr5, ptr1);
+
+    allocator.Free(ptr4);
+    allocator.Free(ptr5);
+    ASSERT_EQ(allocator.GetUsed(), 0);
+
+    void* ptr6 = allocator.Allocate(1000, 8);
+    ASSERT_EQ(ptr6, ptr1);
+    allocator.Free(ptr6);
+}
+
+TEST(FreeListAllocator, FindBestPicksSmallestFittingBlock) {
+    FreeListAllocator allocator(4096, FreeListAllocator::FIND_BEST);
+    allocator.Init();
+
+    // Separators keep the freed blocks from merging
+    void* large = allocator.Allocate(400, 8);
+    void* separator1 = allocator.Allocate(16, 8);
+    void* small = allocator.Allocate(100, 8);
+    void* separator2 = allocator.Allocate(16, 8);
+    void* medium = allocator.Allocate(200, 8);
+    void* separator3 = allocator.Allocate(16, 8);
+    allocator.Free(large);
+    allocator.Free(small);
+    allocator.Free(medium);
+
+    ASSERT_EQ(allocator.Allocate(90, 8), small);
+    ASSERT_EQ(allocator.Allocate(150, 8), medium);
+    ASSERT_EQ(allocator.Allocate(300, 8), large);
+
+    void* aligned = allocator.Allocate(64, 64);
+    ASSERT_EQ(reinterpret_cast<std::size_t>(aligned) % 64, 0);
+
+    allocator.Free(separator1);
+    allocator.Free(separator2);
+    allocator.Free(separator3);
+}
+
+TEST(FreeListAllocator, FindBestManyBlocks) {
+    FreeListAllocator allocator(1 << 20, FreeListAllocator::FIND_BEST);
+    allocator.Init();
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 2000; ++i) {
+        ptrs.push_back(allocator.Allocate(16 + (i * 37) % 300, 8 << (i % 3)));
+        ASSERT_NE(ptrs.back(), nullptr);
+    }
+    for (std::size_t i = 0; i < ptrs.size(); i += 2) {
+        allocator.Free(ptrs[i]);
+    }
+    for (std::size_t i = 1; i < ptrs.size(); i += 2) {
+        allocator.Free(ptrs[i]);
+    }
+    ASSERT_EQ(allocator.GetUsed(), 0);
+    ASSERT_NE(allocator.Allocate((1 << 20) - 64, 8), nullptr);
+}
+
+TEST(FreeListAllocator, FindBinnedPicksSmallestFittingBin) {
+    FreeListAllocator allocator(1 << 16, FreeListAllocator::FIND_BINNED);
+    allocator.Init();
+
+    // Many small fragments in front would be walked by first fit
+    std::vector<void*> fragments;
+    std::vector<void*> separators;
+    for (int i = 0; i < 100; ++i) {
+        fragments.push_back(allocator.Allocate(16, 8));
+        separators.push_back(allocator.Allocate(16, 8));
+    }
+    void* large = allocator.Allocate(3000, 8);
+    separators.push_back(allocator.Allocate(16, 8));
+    void* medium = allocator.Allocate(200, 8);
+    separators.push_back(allocator.Allocate(16, 8));
+    for (void* fragment : fragments) {
+        allocator.Free(fragment);
+    }
+    allocator.Free(large);
+    allocator.Free(medium);
+
+    ASSERT_EQ(allocator.Allocate(16, 8), fragments.back());
+    ASSERT_EQ(allocator.Allocate(150, 8), medium);
+    ASSERT_EQ(allocator.Allocate(2500, 8), large);
+
+    void* aligned = allocator.Allocate(64, 64);
+    ASSERT_EQ(reinterpret_cast<std::size_t>(aligned) % 64, 0);
+}
+
+TEST(FreeListAllocator, FindBinnedManyBlocks) {
+    FreeListAllocator allocator(1 << 20, FreeListAllocator::FIND_BINNED);
+    allocator.Init();
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 2000; ++i) {
+        ptrs.push_back(allocator.Allocate(16 + (i * 37) % 3000 / 7, 8 << (i % 3)));
+        ASSERT_NE(ptrs.back(), nullptr);
+    }
+    // Free every other block, then reuse the holes before freeing everything
+    for (std::size_t i = 0; i < ptrs.size(); i += 2) {
+        allocator.Free(ptrs[i]);
+    }
+    for (std::size_t i = 0; i < ptrs.size(); i += 2) {
+        ptrs[i] = allocator.Allocate(16 + (i * 11) % 200, 8);
+        ASSERT_NE(ptrs[i], nullptr);
+    }
+    for (void* ptr : ptrs) {
+        allocator.Free(ptr);
+    }
+    ASSERT_EQ(allocator.GetUsed(), 0);
+    ASSERT_NE(allocator.Allocate((1 << 20) - 64, 8), nullptr);
+}
+
+TEST(FreeListAllocator, FindBinnedHeaderless) {
+    FreeListAllocator allocator(1 << 16, FreeListAllocator::FIND_BINNED);
+    allocator.SetHeaderlessMode();
+    allocator.Init();
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 500; ++i) {
+        ptrs.push_back(allocator.Allocate(24, 8));
+    }
+    ASSERT_EQ((char*) ptrs[1] - (char*) ptrs[0], 24);
+    for (std::size_t i = 0; i < ptrs.size(); i += 2) {
+        allocator.FreeSized(ptrs[i], 24);
+    }
+    for (std::size_t i = 1; i < ptrs.size(); i += 2) {
+        allocator.FreeSized(ptrs[i], 24);
+    }
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+    ASSERT_NE(allocator.Allocate((1 << 16) - 8, 8), nullptr);
+}
+
+TEST(FreeListAllocator, ReallocateAbsorbsNextFreeBlock) {
+    for (FreeListAllocator::PlacementPolicy policy : {FreeListAllocator::FIND_FIRST, FreeListAllocator::FIND_BEST, FreeListAllocator::FIND_BINNED}) {
+        FreeListAllocator allocator(4096, policy);
+        allocator.Init();
+
+        char* ptr = static_cast<char*>(allocator.Allocate(64, 8));
+        void* next = allocator.Allocate(256, 8);
+        void* guard = allocator.Allocate(64, 8);
+        for (int i = 0; i < 64; ++i) {
+            ptr[i] = (char) i;
+        }
+        allocator.Free(next);
+
+        // Grows over the freed neighbour without moving
+        ASSERT_EQ(allocator.Reallocate(ptr, 200, 8), ptr);
+        for (int i = 0; i < 64; ++i) {
+            ASSERT_EQ(ptr[i], (char) i);
+        }
+        // What is left of the neighbour is still usable
+        void* rest = allocator.Allocate(24, 8);
+        ASSERT_GT(rest, (void*) (ptr + 200));
+        ASSERT_LT(rest, guard);
+
+        // Shrinking gives the tail back
+        const std::size_t used = allocator.GetUsed();
+        ASSERT_EQ(allocator.Reallocate(ptr, 16, 8), ptr);
+        ASSERT_LT(allocator.GetUsed(), used);
+
+        allocator.Free(rest);
+        allocator.Free(guard);
+        allocator.Free(ptr);
+        ASSERT_EQ(allocator.GetUsed(), 0u);
+        // Everything merged back into a single block
+        ASSERT_NE(allocator.Allocate(4000, 8), nullptr);
+    }
+}
+
+TEST(FreeListAllocator, ReallocateMovesWhenNextIsUsed) {
+    FreeListAllocator allocator(4096, FreeListAllocator::FIND_BEST);
+    allocator.Init();
+
+    char* ptr = static_cast<char*>(allocator.Allocate(64, 8));
+    void* next = allocator.Allocate(64, 8);
+    for (int i = 0; i < 64; ++i) {
+        ptr[i] = (char) i;
+    }
+
+    char* moved = static_cast<char*>(allocator.Reallocate(ptr, 512, 8));
+    ASSERT_NE(moved, ptr);
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_EQ(moved[i], (char) i);
+    }
+    allocator.Free(moved);
+    allocator.Free(next);
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+}
+
+TEST(FreeListAllocator, ReallocateGrowingBuffer) {
+    FreeListAllocator allocator(1 << 20, FreeListAllocator::FIND_FIRST);
+    allocator.Init();
+
+    for (int round = 0; round < 4; ++round) {
+        char* buffer = static_cast<char*>(allocator.Allocate(64, 8));
+        buffer[0] = 42;
+        for (std::size_t size = 128; size <= 65536; size += 64) {
+            buffer = static_cast<char*>(allocator.Reallocate(buffer, size, 8));
+            ASSERT_NE(buffer, nullptr);
+            ASSERT_EQ(buffer[0], 42);
+            buffer[size - 1] = 1;
+        }
+        allocator.Free(buffer);
+        ASSERT_EQ(allocator.GetUsed(), 0u);
+    }
+}
+
+TEST(FreeListAllocator, ReallocateReturnsNullWhenOutOfMemory) {
+    FreeListAllocator allocator(4096, FreeListAllocator::FIND_FIRST);
+    allocator.Init();
+
+    char* ptr = static_cast<char*>(allocator.Allocate(64, 8));
+    void* next = allocator.Allocate(64, 8);
+    for (int i = 0; i < 64; ++i) {
+        ptr[i] = (char) i;
+    }
+    const std::size_t used = allocator.GetUsed();
+
+    // Neither in place nor moved, the block stays where it is
+    ASSERT_EQ(allocator.Reallocate(ptr, 8192, 8), nullptr);
+    ASSERT_EQ(allocator.GetUsed(), used);
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_EQ(ptr[i], (char) i);
+    }
+    ASSERT_EQ(allocator.Reallocate(nullptr, 8192, 8), nullptr);
+    ASSERT_EQ(allocator.Allocate(8192, 8), nullptr);
+
+    allocator.Free(ptr);
+    allocator.Free(next);
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+}
+
+TEST(FreeListAllocator, ReallocateThroughLockedAllocator) {
+    LockedAllocator allocator(std::unique_ptr<Allocator>(new FreeListAllocator(4096, FreeListAllocator::FIND_FIRST)));
+    allocator.Init();
+
+    char* ptr = static_cast<char*>(allocator.Allocate(64, 8));
+    ptr[0] = 42;
+    char* grown = static_cast<char*>(allocator.Reallocate(ptr, 1024, 8));
+    ASSERT_EQ(grown, ptr);
+    ASSERT_EQ(grown[0], 42);
+    ASSERT_GE(allocator.GetUsed(), 1024u);
+    ASSERT_GE(allocator.GetPeak(), 1024u);
+
+    ASSERT_EQ(allocator.Reallocate(grown, 8192, 8), nullptr);
+    allocator.Free(grown);
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+}
+
+TEST(FreeListAllocator, HeaderlessBlocksArePacked) {
+    for (FreeListAllocator::PlacementPolicy policy : {FreeListAllocator::FIND_FIRST, FreeListAllocator::FIND_BEST, FreeListAllocator::FIND_BINNED}) {
+        FreeListAllocator allocator(4096, policy);
+        allocator.SetHeaderlessMode();
+        allocator.Init();
+
+        char* first = static_cast<char*>(allocator.Allocate(24, 8));
+        char* second = static_cast<char*>(allocator.Allocate(24, 8));
+        ASSERT_EQ(second - first, 24);
+        ASSERT_EQ(allocator.GetUsed(), 48u);
+
+        void* aligned = allocator.Allocate(40, 64);
+        ASSERT_EQ(reinterpret_cast<std::size_t>(aligned) % 64, 0u);
+
+        allocator.FreeSized(first, 24);
+        allocator.FreeSized(aligned, 40);
+        allocator.FreeSized(second, 24);
+        ASSERT_EQ(allocator.GetUsed(), 0u);
+        // Small leftovers merged back into one block
+        ASSERT_NE(allocator.Allocate(4096, 8), nullptr);
+    }
+}
+
+TEST(FreeListAllocator, HeaderlessRandomFreeOrder) {
+    FreeListAllocator allocator(1 << 20, FreeListAllocator::FIND_BEST);
+    allocator.SetHeaderlessMode();
+    allocator.Init();
+
+    std::vector<std::pair<char*, std::size_t>> blocks;
+    for (std::size_t i = 0; i < 2000; ++i) {
+        const std::size_t size = 8 + (i * 13) % 120;
+        char* ptr = static_cast<char*>(allocator.Allocate(size, 8));
+        memset(ptr, (int) i, size);
+        blocks.emplace_back(ptr, size);
+    }
+    // Every third block first, then the rest, so both neighbours are free in many cases
+    for (std::size_t i = 0; i < blocks.size(); i += 3) {
+        allocator.FreeSized(blocks[i].first, blocks[i].second);
+    }
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+        if (i % 3 != 0) {
+            ASSERT_EQ(blocks[i].first[blocks[i].second - 1], (char) i);
+            allocator.FreeSized(blocks[i].first, blocks[i].second);
+        }
+    }
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+    ASSERT_NE(allocator.Allocate((1 << 20) - 8, 8), nullptr);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "HandlePool.h"
+#include <memory>
+#include <set>
+#include <string>
+
+struct Entity {
+    int id;
+    std::string name;
+
+    Entity(const int id, const std::string& name) : id{id}, name{name} {}
+};
+
+static_assert(sizeof(HandlePool<Entity>::Handle) == 4, "");
+
+TEST(HandlePoolTests, CreateAndGet) {
+    HandlePool<Entity> pool(16);
+    pool.Init();
+
+    HandlePool<Entity>::Handle first = pool.Create(1, "first");
+    HandlePool<Entity>::Handle second = pool.Create(2, "second");
+    ASSERT_FALSE(first.IsNull());
+    ASSERT_NE(first, second);
+    ASSERT_EQ(pool.GetSize(), 2u);
+    ASSERT_EQ(pool.Get(first)->name, "first");
+    ASSERT_EQ(pool.Get(second)->id, 2);
+    ASSERT_EQ(pool.Get(HandlePool<Entity>::Handle()), nullptr);
+}
+
+TEST(HandlePoolTests, StaleHandleIsDetected) {
+    HandlePool<Entity> pool(4);
+    pool.Init();
+
+    HandlePool<Entity>::Handle stale = pool.Create(1, "old");
+    pool.Destroy(stale);
+    ASSERT_FALSE(pool.IsValid(stale));
+    ASSERT_EQ(pool.Get(stale), nullptr);
+
+    // The slot is reused with a new generation
+    HandlePool<Entity>::Handle fresh = pool.Create(2, "new");
+    ASSERT_EQ(fresh.GetIndex(), stale.GetIndex());
+    ASSERT_NE(fresh.GetGeneration(), stale.GetGeneration());
+    ASSERT_EQ(pool.Get(stale), nullptr);
+    ASSERT_EQ(pool.Get(fresh)->name, "new");
+}
+
+TEST(HandlePoolTests, ForgedHandleToFreeSlotIsRejected) {
+    HandlePool<Entity, 8> pool(8);
+    pool.Init();
+    pool.Create(1, "live");
+    ASSERT_FALSE(pool.IsValid(HandlePool<Entity, 8>::Handle((1u << 8) | 5)));
+    ASSERT_FALSE(pool.IsValid(HandlePool<Entity, 8>::Handle((1u << 8) | 200)));
+}
+
+TEST(HandlePoolTests, FullPoolReturnsNullHandle) {
+    HandlePool<Entity> pool(2);
+    pool.Init();
+    pool.Create(1, "a");
+    pool.Create(2, "b");
+    ASSERT_TRUE(pool.Create(3, "c").IsNull());
+}
+
+TEST(HandlePoolTests, DenseIterationAfterDestroy) {
+    HandlePool<Entity> pool(8);
+    pool.Init();
+
+    HandlePool<Entity>::Handle handles[8];
+    for (int i = 0; i < 8; ++i) {
+        handles[i] = pool.Create(i, std::to_string(i));
+    }
+    pool.Destroy(handles[1]);
+    pool.Destroy(handles[4]);
+    pool.Destroy(handles[7]);
+
+    std::set<int> ids;
+    for (const Entity& entity : pool) {
+        ids.insert(entity.id);
+    }
+    ASSERT_EQ(ids, std::set<int>({0, 2, 3, 5, 6}));
+
+    // Moved objects are still found through their handles
+    for (const int id : {0, 2, 3, 5, 6}) {
+        ASSERT_EQ(pool.Get(handles[id])->id, id);
+        ASSERT_EQ(pool.Get(handles[id])->name, std::to_string(id));
+    }
+    for (std::size_t i = 0; i < pool.GetSize(); ++i) {
+        ASSERT_EQ(pool.Get(pool.HandleAt(i)), pool.begin() + i);
+    }
+}
+
+TEST(HandlePoolTests, GenerationWrapsWithoutNullHandle) {
+    // 2 generation bits: generations cycle through 1, 2, 3
+    HandlePool<int, 30> pool(1);
+    pool.Init();
+    for (int i = 0; i < 10; ++i) {
+        HandlePool<int, 30>::Handle handle = pool.Create(i);
+        ASSERT_FALSE(handle.IsNull());
+        ASSERT_NE(handle.GetGeneration(), 0u);
+        ASSERT_EQ(*pool.Get(handle), i);
+        pool.Destroy(handle);
+    }
+}
+
+TEST(HandlePoolTests, DestructorDestroysLiveObjects) {
+    std::shared_ptr<int> counter = std::make_shared<int>(0);
+    {
+        HandlePool<std::shared_ptr<int>> pool(4);
+        pool.Init();
+        pool.Create(counter);
+        pool.Create(counter);
+        ASSERT_EQ(counter.use_count(), 3);
+        pool.Init();
+        ASSERT_EQ(counter.use_count(), 1);
+        pool.Create(counter);
+    }
+    ASSERT_EQ(counter.use_count(), 1);
+}
@@ -1,5 +1,9 @@
 #include "LinearAllocator.h"
+#include "ScopedArena.h"
 #include <gtest/gtest.h>
+#include <cstring>
+#include <sys/mman.h>
+#include <vector>
 
 TEST(LinearAllocatorTests, AllocateAndReset) {
     LinearAllocator allocator(1024);
@@ -51,3 +55,216 @@ TEST(LinearAllocatorTests, FreeNotAllowed) {
 
     ASSERT_DEATH(allocator.Free(ptr), "Use Reset\\(\\) method");
 }
+
+TEST(LinearAllocatorTests, ChainedGrowsPastFirstBlock) {
+    LinearAllocator allocator(128, 1024);
+    allocator.Init();
+
+    void* ptr1 = allocator.Allocate(100, 8);
+    ASSERT_NE(ptr1, nullptr);
+
+    // Does not fit in the first block, a new one is chained
+    void* ptr2 = allocator.Allocate(100, 8);
+    ASSERT_NE(ptr2, nullptr);
+    ASSERT_EQ(allocator.GetUsed(), 200u);
+
+    // Bigger than the maximum block size, gets a dedicated block
+    void* ptr3 = allocator.Allocate(4096, 16);
+    ASSERT_NE(ptr3, nullptr);
+    ASSERT_EQ(reinterpret_cast<std::size_t>(ptr3) % 16, 0u);
+    memset(ptr3, 0, 4096);
+}
+
+TEST(LinearAllocatorTests, ChainedAllocationIsAlignedAfterGrow) {
+    LinearAllocator allocator(128, 4096);
+    allocator.Init();
+
+    ASSERT_NE(allocator.Allocate(100, 8), nullptr);
+    // Chained data starts past the block header, not on a 64 byte boundary
+    void* ptr = allocator.Allocate(64, 64);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ(reinterpret_cast<std::size_t>(ptr) % 64, 0u);
+    memset(ptr, 0, 64);
+
+    void* next = allocator.Allocate(8, 128);
+    ASSERT_EQ(reinterpret_cast<std::size_t>(next) % 128, 0u);
+}
+
+TEST(LinearAllocatorTests, ChainedResetRewindsToFirstBlock) {
+    LinearAllocator allocator(256, 4096);
+    allocator.Init();
+
+    void* first = allocator.Allocate(64, 8);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_NE(allocator.Allocate(64, 8), nullptr);
+    }
+    ASSERT_EQ(allocator.GetUsed(), 101u * 64);
+
+    allocator.Reset();
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+    ASSERT_EQ(allocator.Allocate(64, 8), first);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_NE(allocator.Allocate(64, 8), nullptr);
+    }
+}
+
+TEST(LinearAllocatorTests, FixedModeDoesNotGrow) {
+    LinearAllocator allocator(128, 0);
+    allocator.Init();
+
+    ASSERT_NE(allocator.Allocate(128), nullptr);
+    ASSERT_EQ(allocator.Allocate(8), nullptr);
+}
+
+TEST(LinearAllocatorTests, ReserveModeCommitsLazilyAndTrimsOnReset) {
+    const std::size_t totalSize = 64 * 1024 * 1024;
+    const std::size_t retainedSize = 2 * 1024 * 1024;
+    LinearAllocator allocator(totalSize);
+    allocator.SetRegionProvider(RegionProvider::Get(RegionProvider::MMAP));
+    allocator.SetReserveMode(retainedSize);
+    allocator.Init();
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 1000; ++i) {
+        void* ptr = allocator.Allocate(16 * 1024, 16);
+        ASSERT_NE(ptr, nullptr);
+        memset(ptr, i, 16 * 1024);
+        ptrs.push_back(ptr);
+    }
+
+    allocator.Reset();
+    const std::size_t pageSize = RegionProvider::GetPageSize();
+    std::vector<unsigned char> pages(totalSize / pageSize);
+    mincore(ptrs[0], totalSize, pages.data());
+    std::size_t resident = 0;
+    for (unsigned char page : pages) {
+        resident += page & 1;
+    }
+    ASSERT_LE(resident * pageSize, retainedSize);
+
+    ASSERT_EQ(allocator.Allocate(16 * 1024, 16), ptrs[0]);
+    memset(ptrs[0], 0, 16 * 1024);
+}
+
+TEST(LinearAllocatorTests, FreeToMarker) {
+    LinearAllocator allocator(1024);
+    allocator.Init();
+
+    ASSERT_NE(allocator.Allocate(100, 8), nullptr);
+    const LinearAllocator::Marker marker = allocator.GetMarker();
+    void* first = allocator.Allocate(64, 8);
+    ASSERT_NE(allocator.Allocate(64, 8), nullptr);
+
+    allocator.FreeToMarker(marker);
+    ASSERT_EQ(allocator.GetUsed(), 100u);
+    ASSERT_EQ(allocator.Allocate(64, 8), first);
+}
+
+TEST(LinearAllocatorTests, ScopedArenaReleasesChainedBlocks) {
+    LinearAllocator allocator(256, 4096);
+    allocator.Init();
+
+    void* outer = allocator.Allocate(200, 8);
+    ASSERT_NE(outer, nullptr);
+    for (int round = 0; round < 3; ++round) {
+        ScopedArena<LinearAllocator> scope(allocator);
+        for (int i = 0; i < 100; ++i) {
+            void* ptr = scope.Allocate(128, 16);
+            ASSERT_NE(ptr, nullptr);
+            memset(ptr, i, 128);
+        }
+        ASSERT_GE(allocator.GetUsed(), 200u + 100 * 128);
+    }
+    ASSERT_EQ(allocator.GetUsed(), 200u);
+
+    // Back in the first block, right after the outer allocation
+    void* next = allocator.Allocate(8, 8);
+    ASSERT_EQ(static_cast<char*>(next), static_cast<char*>(outer) + 200);
+}
+
+TEST(LinearAllocatorTests, BatchIsOneBump) {
+    LinearAllocator allocator(1024);
+    allocator.Init();
+
+    ASSERT_NE(allocator.Allocate(1, 1), nullptr);
+    void* ptrs[10];
+    ASSERT_EQ(allocator.AllocateBatch(24, 10, ptrs, 16), 10u);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(reinterpret_cast<std::size_t>(ptrs[i]) % 16, 0u);
+        ASSERT_EQ(static_cast<char*>(ptrs[i]), static_cast<char*>(ptrs[0]) + i * 32);
+    }
+    // The last block ends right after its 24 bytes
+    ASSERT_EQ(allocator.Allocate(1, 1), static_cast<char*>(ptrs[9]) + 24);
+}
+
+TEST(LinearAllocatorTests, BatchStopsWhenFull) {
+    LinearAllocator allocator(256);
+    allocator.Init();
+
+    void* ptrs[10];
+    ASSERT_EQ(allocator.AllocateBatch(64, 10, ptrs), 4u);
+    ASSERT_EQ(allocator.GetUsed(), 256u);
+}
+
+TEST(LinearAllocatorTests, ChainedBatchContinuesInNewBlock) {
+    LinearAllocator allocator(128, 4096);
+    allocator.Init();
+
+    void* ptrs[10];
+    ASSERT_EQ(allocator.AllocateBatch(64, 10, ptrs, 8), 10u);
+    for (void* ptr : ptrs) {
+        memset(ptr, 0, 64);
+    }
+    ASSERT_EQ(allocator.GetUsed(), 640u);
+}
+
+TEST(LinearAllocatorTests, ChainedBatchIsAlignedInNewBlock) {
+    LinearAllocator allocator(128, 4096);
+    allocator.Init();
+
+    ASSERT_NE(allocator.Allocate(100, 8), nullptr);
+    void* ptrs[10];
+    ASSERT_EQ(allocator.AllocateBatch(48, 10, ptrs, 64), 10u);
+    for (void* ptr : ptrs) {
+        ASSERT_EQ(reinterpret_cast<std::size_t>(ptr) % 64, 0u);
+        memset(ptr, 0, 48);
+    }
+}
+
+TEST(LinearAllocatorTests, ReallocateExtendsLastAllocation) {
+    LinearAllocator allocator(1024);
+    allocator.Init();
+
+    char* first = static_cast<char*>(allocator.Allocate(16, 8));
+    char* last = static_cast<char*>(allocator.Allocate(16, 8));
+    memset(first, 1, 16);
+    memset(last, 2, 16);
+
+    ASSERT_EQ(allocator.Reallocate(last, 200), last);
+    ASSERT_EQ(allocator.GetUsed(), 216u);
+    ASSERT_EQ(allocator.Reallocate(last, 32), last);
+    ASSERT_EQ(allocator.GetUsed(), 48u);
+
+    // Not the last one anymore, it is copied
+    char* moved = static_cast<char*>(allocator.Reallocate(first, 64, 8));
+    ASSERT_EQ(moved, last + 32);
+    for (int i = 0; i < 16; ++i) {
+        ASSERT_EQ(moved[i], 1);
+    }
+}
+
+TEST(LinearAllocatorTests, ChainedReallocateMovesToNewBlock) {
+    LinearAllocator allocator(128, 4096);
+    allocator.Init();
+
+    char* ptr = static_cast<char*>(allocator.Allocate(64, 8));
+    memset(ptr, 3, 64);
+    char* moved = static_cast<char*>(allocator.Reallocate(ptr, 1000, 8));
+    ASSERT_NE(moved, ptr);
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_EQ(moved[i], 3);
+    }
+    // The copy is now the last allocation and is resized in place within its block
+    ASSERT_EQ(allocator.Reallocate(moved, 500), moved);
+    ASSERT_EQ(allocator.Reallocate(moved, 1000), moved);
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include "OwnerPoolAllocator.h"
+#include <atomic>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST(OwnerPoolAllocatorTests, AllocateAndFreeLocally) {
+    OwnerPoolAllocator allocator(1 << 20, 64, 1 << 16);
+    allocator.Init();
+
+    void* ptr1 = allocator.Allocate(64, 8);
+    void* ptr2 = allocator.Allocate(48, 8);
+    ASSERT_NE(ptr1, nullptr);
+    ASSERT_NE(ptr1, ptr2);
+    ASSERT_EQ(reinterpret_cast<std::size_t>(ptr1) % 16, 0u);
+    ASSERT_EQ(allocator.GetUsed(), 128u);
+
+    // Local frees are reused first
+    allocator.Free(ptr2);
+    ASSERT_EQ(allocator.Allocate(64, 8), ptr2);
+    allocator.Free(ptr1);
+    allocator.Free(ptr2);
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+    ASSERT_EQ(allocator.GetOwnedSpanCount(), 1u);
+}
+
+TEST(OwnerPoolAllocatorTests, ThreadsGetTheirOwnSpans) {
+    OwnerPoolAllocator allocator(1 << 20, 64, 1 << 16);
+    allocator.Init();
+
+    void* mine = allocator.Allocate(64, 8);
+    void* theirs = nullptr;
+    std::size_t theirSpans = 0;
+    std::thread other([&allocator, &theirs, &theirSpans]() {
+        theirs = allocator.Allocate(64, 8);
+        theirSpans = allocator.GetOwnedSpanCount();
+    });
+    other.join();
+
+    ASSERT_EQ(theirSpans, 1u);
+    ASSERT_NE(reinterpret_cast<std::size_t>(mine) >> 16, reinterpret_cast<std::size_t>(theirs) >> 16);
+}
+
+TEST(OwnerPoolAllocatorTests, RemoteFreesAreReclaimedByTheOwner) {
+    // A single span, so the owner can only go on once the remote frees come back
+    const std::size_t spanSize = 4096;
+    OwnerPoolAllocator allocator(spanSize, 64, spanSize);
+    allocator.Init();
+
+    std::vector<void*> ptrs;
+    while (void* ptr = allocator.Allocate(64, 8)) {
+        ptrs.push_back(ptr);
+    }
+    ASSERT_GT(ptrs.size(), 32u);
+
+    std::thread other([&allocator, &ptrs]() {
+        for (void* ptr : ptrs) {
+            allocator.Free(ptr);
+        }
+    });
+    other.join();
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+
+    std::set<void*> reclaimed;
+    for (std::size_t i = 0; i < ptrs.size(); ++i) {
+        void* ptr = allocator.Allocate(64, 8);
+        ASSERT_NE(ptr, nullptr);
+        reclaimed.insert(ptr);
+    }
+    ASSERT_EQ(reclaimed, std::set<void*>(ptrs.begin(), ptrs.end()));
+    ASSERT_EQ(allocator.Allocate(64, 8), nullptr);
+}
+
+TEST(OwnerPoolAllocatorTests, ProducerConsumer) {
+    OwnerPoolAllocator allocator(1 << 18, 64, 1 << 14);
+    allocator.Init();
+
+    // Far more blocks than the region holds go through a small ring, so remote frees must be reused
+    const std::size_t nBlocks = 200000;
+    const std::size_t ringSize = 1024;
+    std::vector<std::atomic<void*>> ring(ringSize);
+    for (std::atomic<void*>& slot : ring) {
+        slot.store(nullptr);
+    }
+
+    std::thread consumer([&ring, &allocator, nBlocks, ringSize]() {
+        for (std::size_t i = 0; i < nBlocks; ++i) {
+            void* ptr;
+            while ((ptr = ring[i % ringSize].exchange(nullptr, std::memory_order_acquire)) == nullptr) {
+                std::this_thread::yield();
+            }
+            ASSERT_EQ(*(std::size_t*) ptr, i);
+            allocator.Free(ptr);
+        }
+    });
+
+    for (std::size_t i = 0; i < nBlocks; ++i) {
+        void* ptr;
+        while ((ptr = allocator.Allocate(64, 8)) == nullptr) {
+            std::this_thread::yield();
+        }
+        *(std::size_t*) ptr = i;
+        while (ring[i % ringSize].load(std::memory_order_relaxed) != nullptr) {
+            std::this_thread::yield();
+        }
+        ring[i % ringSize].store(ptr, std::memory_order_release);
+    }
+    consumer.join();
+
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+    ASSERT_LE(allocator.GetPeak(), (std::size_t) 1 << 18);
+}
+
+TEST(OwnerPoolAllocatorTests, ThreadsPastMaxThreadsFreeRemotely) {
+    OwnerPoolAllocator allocator(1 << 20, 64, 1 << 16, 1);
+    allocator.Init();
+
+    // The calling thread takes the only heap, the others are alive at the same time and have none
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 4; ++i) {
+        ptrs.push_back(allocator.Allocate(64, 8));
+        ASSERT_NE(ptrs.back(), nullptr);
+    }
+    std::atomic<int> done{0};
+    std::atomic<bool> release{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&allocator, &ptrs, &done, &release, t]() {
+            ASSERT_EQ(allocator.Allocate(64, 8), nullptr);
+            ASSERT_EQ(allocator.GetOwnedSpanCount(), 0u);
+            allocator.Free(ptrs[t]);
+            ++done;
+            while (!release) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    while (done < 4) {
+        std::this_thread::yield();
+    }
+    release = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+    ASSERT_NE(allocator.Allocate(64, 8), nullptr);
+}
+
+TEST(OwnerPoolAllocatorTests, ResetReturnsEverySpan) {
+    OwnerPoolAllocator allocator(1 << 16, 64, 1 << 14);
+    allocator.Init();
+    for (int i = 0; i < 1000; ++i) {
+        allocator.Allocate(64, 8);
+    }
+    ASSERT_EQ(allocator.GetPeak(), (std::size_t) 1 << 16);
+    allocator.Reset();
+    ASSERT_EQ(allocator.GetPeak(), 0u);
+    ASSERT_EQ(allocator.GetOwnedSpanCount(), 0u);
+    ASSERT_NE(allocator.Allocate(64, 8), nullptr);
+}
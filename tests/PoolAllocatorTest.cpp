@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
-#include "PoolAllocator.h"
+#include "PoolAllocator.h"
+#include <cstring>
+#include <set>
+#include <vector>
 
 TEST(PoolAllocatorTest, AllocateAndFree) {
     const std::size_t totalSize = 1024;
@@ -118,3 +121,101 @@ TEST(PoolAllocatorTest, FreeInvalidPointer)
     void *invalidPtr = reinterpret_cast<void *>(0x12345678);
     ASSERT_DEATH(allocator.Free(invalidPtr), "");
 }
+
+TEST(PoolAllocatorTest, GrowsPastInitialRegion)
+{
+    const std::size_t chunkSize = 64;
+    PoolAllocator allocator(4 * chunkSize, chunkSize, 4096, 0);
+    allocator.Init();
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 200; ++i) {
+        void* ptr = allocator.Allocate(chunkSize, 0);
+        ASSERT_NE(ptr, nullptr);
+        memset(ptr, i, chunkSize);
+        ptrs.push_back(ptr);
+    }
+    ASSERT_EQ(allocator.GetUsed(), 200 * chunkSize);
+    ASSERT_GT(allocator.GetSpanCount(), 0u);
+
+    std::set<void*> unique(ptrs.begin(), ptrs.end());
+    ASSERT_EQ(unique.size(), ptrs.size());
+
+    for (void* ptr : ptrs) {
+        allocator.Free(ptr);
+    }
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+    // No empty span is retained
+    ASSERT_EQ(allocator.GetSpanCount(), 0u);
+}
+
+TEST(PoolAllocatorTest, RetainsEmptySpansUpToHighWaterMark)
+{
+    const std::size_t chunkSize = 64;
+    const std::size_t spanSize = 4096;
+    PoolAllocator allocator(chunkSize, chunkSize, spanSize, 2);
+    allocator.Init();
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 300; ++i) {
+        ptrs.push_back(allocator.Allocate(chunkSize, 0));
+    }
+    const std::size_t spans = allocator.GetSpanCount();
+    ASSERT_GE(spans, 4u);
+
+    for (void* ptr : ptrs) {
+        allocator.Free(ptr);
+    }
+    ASSERT_EQ(allocator.GetSpanCount(), 2u);
+
+    // Cached spans are reused before new ones are acquired
+    ptrs.clear();
+    for (int i = 0; i < 100; ++i) {
+        ptrs.push_back(allocator.Allocate(chunkSize, 0));
+    }
+    ASSERT_EQ(allocator.GetSpanCount(), 2u);
+
+    allocator.Reset();
+    ASSERT_EQ(allocator.GetSpanCount(), 0u);
+}
+
+TEST(PoolAllocatorTest, BatchSplicesFreeList)
+{
+    const std::size_t chunkSize = 16;
+    PoolAllocator allocator(64 * chunkSize, chunkSize);
+    allocator.Init();
+
+    void* ptrs[80];
+    ASSERT_EQ(allocator.AllocateBatch(chunkSize, 40, ptrs), 40u);
+    // Only 24 chunks are left
+    ASSERT_EQ(allocator.AllocateBatch(chunkSize, 40, ptrs + 40), 24u);
+    ASSERT_EQ(allocator.GetUsed(), 64 * chunkSize);
+    std::set<void*> unique(ptrs, ptrs + 64);
+    ASSERT_EQ(unique.size(), 64u);
+
+    allocator.FreeBatch(ptrs, 40);
+    ASSERT_EQ(allocator.GetUsed(), 24 * chunkSize);
+    void* again[40];
+    ASSERT_EQ(allocator.AllocateBatch(chunkSize, 40, again), 40u);
+    ASSERT_EQ(std::set<void*>(again, again + 40), std::set<void*>(ptrs, ptrs + 40));
+}
+
+TEST(PoolAllocatorTest, BatchGrowsIntoSpans)
+{
+    const std::size_t chunkSize = 64;
+    PoolAllocator allocator(4 * chunkSize, chunkSize, 4096, 0);
+    allocator.Init();
+
+    std::vector<void*> ptrs(200);
+    ASSERT_EQ(allocator.AllocateBatch(chunkSize, ptrs.size(), ptrs.data()), ptrs.size());
+    for (void* ptr : ptrs) {
+        memset(ptr, 0, chunkSize);
+    }
+    ASSERT_GT(allocator.GetSpanCount(), 0u);
+    ASSERT_EQ(std::set<void*>(ptrs.begin(), ptrs.end()).size(), ptrs.size());
+
+    // Mixes chunks of the initial region and of the spans
+    allocator.FreeBatch(ptrs.data(), ptrs.size());
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+    ASSERT_EQ(allocator.GetSpanCount(), 0u);
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <string>
+#include <sys/wait.h>
+
+// Runs the workload in a child process with the interposition library preloaded
+static int RunWorkload(const std::string& environment) {
+    const std::string command = environment + " LD_PRELOAD=" PRELOAD_LIBRARY " " PRELOAD_WORKLOAD;
+    const int status = system(command.c_str());
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+TEST(PreloadTests, TLSF) {
+    ASSERT_EQ(RunWorkload("ALLOCATOR=tlsf"), 0);
+}
+
+TEST(PreloadTests, FreeList) {
+    ASSERT_EQ(RunWorkload("ALLOCATOR=freelist"), 0);
+}
+
+TEST(PreloadTests, ThreadCache) {
+    ASSERT_EQ(RunWorkload("ALLOCATOR=threadcache"), 0);
+}
+
+TEST(PreloadTests, SlabFrontOnTLSF) {
+    ASSERT_EQ(RunWorkload("ALLOCATOR=tlsf ALLOCATOR_SMALL=slab"), 0);
+}
+
+TEST(PreloadTests, TransparentHugePages) {
+    ASSERT_EQ(RunWorkload("ALLOCATOR_REGION=thp"), 0);
+}
+
+TEST(PreloadTests, SmallHeapFallsBackToLibc) {
+    ASSERT_EQ(RunWorkload("ALLOCATOR_HEAP_SIZE=1048576"), 0);
+}
+
+TEST(PreloadTests, LibcPassThrough) {
+    ASSERT_EQ(RunWorkload("ALLOCATOR=libc PRELOAD_EXPECT_ACTIVE=0"), 0);
+}
+
+TEST(PreloadTests, Statistics) {
+    ASSERT_EQ(RunWorkload("ALLOCATOR_STATS=1"), 0);
+}
+
+TEST(PreloadTests, Shell) {
+    const int status = system("LD_PRELOAD=" PRELOAD_LIBRARY " /bin/sh -c 'ls / | sort | wc -l' > /dev/null");
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+}
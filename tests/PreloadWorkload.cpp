@@ -0,0 +1,227 @@
+// Runs under LD_PRELOAD from PreloadTests, exits with 0 when every check holds
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <malloc.h>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#define CHECK(cond) do { if (!(cond)) { fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond); return 1; } } while (0)
+
+static bool IsAligned(const void* ptr, const std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+static int CheckActive() {
+    typedef int (*Active)();
+    Active active = reinterpret_cast<Active>(dlsym(RTLD_DEFAULT, "allocpreload_active"));
+    const char* expected = getenv("PRELOAD_EXPECT_ACTIVE");
+    CHECK(active != nullptr);
+    CHECK(active() == (expected != nullptr ? atoi(expected) : 1));
+    return 0;
+}
+
+static int CheckMallocFamily() {
+    for (std::size_t size = 1; size <= (1 << 20); size *= 3) {
+        char* ptr = static_cast<char*>(malloc(size));
+        CHECK(ptr != nullptr);
+        CHECK(IsAligned(ptr, 16));
+        CHECK(malloc_usable_size(ptr) >= size);
+        memset(ptr, 0xAB, size);
+        free(ptr);
+    }
+
+    // Dirty a block so a recycled one would show up in calloc
+    void* dirty = malloc(4096);
+    memset(dirty, 0xFF, 4096);
+    free(dirty);
+    unsigned char* zeroed = static_cast<unsigned char*>(calloc(64, 64));
+    CHECK(zeroed != nullptr);
+    for (std::size_t i = 0; i < 4096; ++i) {
+        CHECK(zeroed[i] == 0);
+    }
+    free(zeroed);
+    volatile std::size_t overflowing = SIZE_MAX / 2;
+    CHECK(calloc(overflowing, 4) == nullptr);
+
+    char* grown = static_cast<char*>(malloc(16));
+    for (int i = 0; i < 16; ++i) {
+        grown[i] = (char) i;
+    }
+    for (std::size_t size = 32; size <= (1 << 16); size *= 2) {
+        grown = static_cast<char*>(realloc(grown, size));
+        CHECK(grown != nullptr);
+        for (int i = 0; i < 16; ++i) {
+            CHECK(grown[i] == (char) i);
+        }
+    }
+    grown = static_cast<char*>(realloc(grown, 8));
+    CHECK(grown != nullptr && grown[7] == 7);
+    free(grown);
+    free(nullptr);
+    return 0;
+}
+
+static int CheckAlignedFamily() {
+    for (std::size_t alignment = 8; alignment <= 4096; alignment *= 2) {
+        void* ptr = nullptr;
+        CHECK(posix_memalign(&ptr, alignment, 100) == 0);
+        CHECK(IsAligned(ptr, alignment));
+        free(ptr);
+
+        ptr = aligned_alloc(alignment, 3 * alignment);
+        CHECK(ptr != nullptr && IsAligned(ptr, alignment));
+        free(ptr);
+
+        ptr = memalign(alignment, 10);
+        CHECK(ptr != nullptr && IsAligned(ptr, alignment));
+        ptr = realloc(ptr, 10000);
+        CHECK(ptr != nullptr);
+        free(ptr);
+    }
+    void* ptr = nullptr;
+    CHECK(posix_memalign(&ptr, 24, 100) != 0);
+    ptr = valloc(10);
+    CHECK(ptr != nullptr && IsAligned(ptr, sysconf(_SC_PAGESIZE)));
+    free(ptr);
+    return 0;
+}
+
+struct alignas(64) CacheLine {
+    char data[64];
+};
+
+static int CheckNewDelete() {
+    int* value = new int(42);
+    CHECK(*value == 42);
+    delete value;
+
+    CacheLine* lines = new CacheLine[7];
+    CHECK(IsAligned(lines, 64));
+    delete[] lines;
+
+    std::vector<std::string> strings;
+    for (int i = 0; i < 10000; ++i) {
+        strings.push_back(std::string(i % 100 + 20, 'x'));
+    }
+    CHECK(strings[9999].size() == 9999 % 100 + 20);
+    return 0;
+}
+
+static int CheckThreads() {
+    const int nThreads = 8;
+    std::vector<int> results(nThreads, 1);
+    std::vector<std::thread> threads;
+    // Every thread frees what its neighbour allocated too
+    std::vector<std::vector<void*>> handoff(nThreads);
+    for (int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([t, &results, &handoff]() {
+            std::vector<void*> ptrs;
+            for (int i = 0; i < 20000; ++i) {
+                const std::size_t size = 8 + (i * 37 + t) % 3000;
+                char* ptr = static_cast<char*>(malloc(size));
+                if (ptr == nullptr) {
+                    return;
+                }
+                ptr[0] = ptr[size - 1] = (char) t;
+                ptrs.push_back(ptr);
+                if (ptrs.size() > 64) {
+                    free(ptrs[i % ptrs.size()]);
+                    ptrs[i % ptrs.size()] = ptrs.back();
+                    ptrs.pop_back();
+                }
+            }
+            handoff[t] = ptrs;
+            results[t] = 0;
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (int t = 0; t < nThreads; ++t) {
+        CHECK(results[t] == 0);
+        for (void* ptr : handoff[(t + 1) % nThreads]) {
+            free(ptr);
+        }
+    }
+    return 0;
+}
+
+// More live threads than threadcache has caches for
+static int CheckManyThreads() {
+    const int nThreads = 300;
+    std::atomic<int> allocated{0};
+    std::atomic<bool> release{false};
+    std::vector<int> results(nThreads, 1);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([t, &allocated, &release, &results]() {
+            std::vector<char*> ptrs;
+            for (int i = 0; i < 16; ++i) {
+                char* ptr = static_cast<char*>(malloc(16 << (i % 8)));
+                if (ptr == nullptr) {
+                    ++allocated;
+                    return;
+                }
+                ptr[0] = (char) t;
+                ptrs.push_back(ptr);
+            }
+            ++allocated;
+            while (!release) {
+                std::this_thread::yield();
+            }
+            results[t] = 0;
+            for (char* ptr : ptrs) {
+                if (ptr[0] != (char) t) {
+                    results[t] = 1;
+                }
+                free(ptr);
+            }
+        });
+    }
+    while (allocated < nThreads) {
+        std::this_thread::yield();
+    }
+    release = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (int t = 0; t < nThreads; ++t) {
+        CHECK(results[t] == 0);
+    }
+    return 0;
+}
+
+static int CheckFork() {
+    void* before = malloc(100);
+    const pid_t pid = fork();
+    CHECK(pid >= 0);
+    if (pid == 0) {
+        void* ptr = malloc(200);
+        free(before);
+        free(ptr);
+        _exit(ptr != nullptr ? 0 : 1);
+    }
+    int status = 0;
+    CHECK(waitpid(pid, &status, 0) == pid);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    free(before);
+    return 0;
+}
+
+int main() {
+    int failures = CheckActive();
+    failures += CheckMallocFamily();
+    failures += CheckAlignedFamily();
+    failures += CheckNewDelete();
+    failures += CheckThreads();
+    failures += CheckManyThreads();
+    failures += CheckFork();
+    return failures;
+}
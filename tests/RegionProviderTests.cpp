@@ -0,0 +1,84 @@
+#include "RegionProvider.h"
+#include "FreeListAllocator.h"
+#include "PoolAllocator.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+namespace {
+const RegionProvider::Backend BACKENDS[] = {RegionProvider::MALLOC, RegionProvider::MMAP, RegionProvider::HUGETLB, RegionProvider::THP};
+}
+
+TEST(RegionProviderTests, AllocateWriteAndFree) {
+    for (RegionProvider::Backend backend : BACKENDS) {
+        RegionProvider* provider = RegionProvider::Get(backend);
+        const std::size_t size = 3 * 1024 * 1024 + 17;
+        void* ptr = provider->Allocate(size);
+        ASSERT_NE(ptr, nullptr) << provider->GetName();
+        memset(ptr, 0xAB, size);
+        provider->Free(ptr, size);
+    }
+}
+
+TEST(RegionProviderTests, AllocateAligned) {
+    for (RegionProvider::Backend backend : BACKENDS) {
+        RegionProvider* provider = RegionProvider::Get(backend);
+        for (std::size_t alignment : {std::size_t(64), std::size_t(65536), std::size_t(4 * 1024 * 1024)}) {
+            void* ptr = provider->Allocate(100000, alignment);
+            ASSERT_NE(ptr, nullptr) << provider->GetName();
+            ASSERT_EQ(reinterpret_cast<std::size_t>(ptr) % alignment, 0u) << provider->GetName();
+            memset(ptr, 0, 100000);
+            provider->Free(ptr, 100000);
+        }
+    }
+}
+
+TEST(RegionProviderTests, FromName) {
+    for (RegionProvider::Backend backend : BACKENDS) {
+        RegionProvider::Backend parsed;
+        ASSERT_TRUE(RegionProvider::FromName(RegionProvider::Get(backend)->GetName(), parsed));
+        ASSERT_EQ(parsed, backend);
+    }
+    RegionProvider::Backend parsed;
+    ASSERT_FALSE(RegionProvider::FromName("jemalloc", parsed));
+}
+
+TEST(RegionProviderTests, AllocatorsUseTheirProvider) {
+    for (RegionProvider::Backend backend : BACKENDS) {
+        FreeListAllocator freeList(1 << 20, FreeListAllocator::FIND_BEST);
+        freeList.SetRegionProvider(RegionProvider::Get(backend));
+        freeList.Init();
+        std::vector<void*> ptrs;
+        for (int i = 0; i < 100; ++i) {
+            void* ptr = freeList.Allocate(1000, 8);
+            ASSERT_NE(ptr, nullptr);
+            memset(ptr, i, 1000);
+            ptrs.push_back(ptr);
+        }
+        for (void* ptr : ptrs) {
+            freeList.Free(ptr);
+        }
+
+        // Growing spans are taken from the provider too
+        PoolAllocator pool(64, 64, 65536, 0);
+        pool.SetRegionProvider(RegionProvider::Get(backend));
+        pool.Init();
+        ptrs.clear();
+        for (int i = 0; i < 5000; ++i) {
+            ptrs.push_back(pool.Allocate(64));
+        }
+        for (void* ptr : ptrs) {
+            pool.Free(ptr);
+        }
+        ASSERT_EQ(pool.GetSpanCount(), 0u);
+    }
+}
+
+TEST(RegionProviderTests, DefaultProvider) {
+    ASSERT_STREQ(RegionProvider::GetDefault()->GetName(), "malloc");
+    RegionProvider::SetDefault(RegionProvider::Get(RegionProvider::MMAP));
+    FreeListAllocator allocator(4096, FreeListAllocator::FIND_FIRST);
+    ASSERT_EQ(allocator.GetRegionProvider(), RegionProvider::Get(RegionProvider::MMAP));
+    RegionProvider::SetDefault(nullptr);
+    ASSERT_STREQ(RegionProvider::GetDefault()->GetName(), "malloc");
+}
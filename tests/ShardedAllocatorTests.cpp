@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "ShardedAllocator.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+TEST(ShardedAllocatorTests, AllocateAndFree) {
+    ShardedAllocator allocator(1 << 20, FreeListAllocator::FIND_FIRST, 4);
+    allocator.Init();
+    ASSERT_EQ(allocator.GetShardCount(), 4u);
+
+    void* ptr1 = allocator.Allocate(100, 8);
+    void* ptr2 = allocator.Allocate(200, 16);
+    ASSERT_NE(ptr1, nullptr);
+    ASSERT_NE(ptr2, nullptr);
+    ASSERT_EQ(reinterpret_cast<std::size_t>(ptr2) % 16, 0u);
+    ASSERT_LT(allocator.ShardOf(ptr1), 4u);
+    ASSERT_GT(allocator.GetUsed(), 300u);
+
+    allocator.Free(ptr1);
+    allocator.Free(ptr2);
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+}
+
+TEST(ShardedAllocatorTests, DefaultsToOneShardPerCpu) {
+    ShardedAllocator allocator(1 << 20, FreeListAllocator::FIND_BINNED);
+    allocator.Init();
+    ASSERT_EQ(allocator.GetShardCount(), std::max(1u, std::thread::hardware_concurrency()));
+}
+
+TEST(ShardedAllocatorTests, FreeFromAnotherThreadGoesToOwningShard) {
+    ShardedAllocator allocator(1 << 20, FreeListAllocator::FIND_BEST, 2);
+    allocator.Init();
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 100; ++i) {
+        ptrs.push_back(allocator.Allocate(64 + i, 8));
+    }
+    std::thread other([&allocator, &ptrs]() {
+        for (void* ptr : ptrs) {
+            allocator.Free(ptr);
+        }
+    });
+    other.join();
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+}
+
+TEST(ShardedAllocatorTests, FullShardFallsBackToNeighbours) {
+    ShardedAllocator allocator(4 * 4096, FreeListAllocator::FIND_FIRST, 4);
+    allocator.Init();
+
+    // Each block takes most of a shard, so every shard serves exactly one
+    std::vector<std::size_t> shards;
+    for (int i = 0; i < 4; ++i) {
+        void* ptr = allocator.Allocate(3000, 8);
+        ASSERT_NE(ptr, nullptr);
+        shards.push_back(allocator.ShardOf(ptr));
+    }
+    std::sort(shards.begin(), shards.end());
+    ASSERT_EQ(std::unique(shards.begin(), shards.end()), shards.end());
+    ASSERT_EQ(allocator.Allocate(3000, 8), nullptr);
+    // Bigger than any shard
+    ASSERT_EQ(allocator.Allocate(8192, 8), nullptr);
+}
+
+TEST(ShardedAllocatorTests, ReallocateStaysInShard) {
+    ShardedAllocator allocator(1 << 20, FreeListAllocator::FIND_FIRST, 2);
+    allocator.Init();
+
+    char* ptr = (char*) allocator.Reallocate(nullptr, 32, 8);
+    memset(ptr, 7, 32);
+    const std::size_t shard = allocator.ShardOf(ptr);
+    ptr = (char*) allocator.Reallocate(ptr, 4096, 8);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ(allocator.ShardOf(ptr), shard);
+    ASSERT_EQ(ptr[31], 7);
+    allocator.Free(ptr);
+}
+
+TEST(ShardedAllocatorTests, ManyThreads) {
+    // More threads than shards, so shards are shared and locks are contended
+    ShardedAllocator allocator(1 << 24, FreeListAllocator::FIND_BINNED, 2);
+    allocator.Init();
+
+    const int nThreads = 8;
+    std::vector<std::thread> threads;
+    std::vector<std::vector<void*>> handoff(nThreads);
+    for (int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&allocator, &handoff, t]() {
+            std::vector<void*> ptrs;
+            for (int i = 0; i < 5000; ++i) {
+                const std::size_t size = 16 + (i * 31 + t) % 500;
+                char* ptr = (char*) allocator.Allocate(size, 8);
+                ptr[0] = ptr[size - 1] = (char) t;
+                ptrs.push_back(ptr);
+                if (ptrs.size() > 50) {
+                    allocator.Free(ptrs[i % ptrs.size()]);
+                    ptrs[i % ptrs.size()] = ptrs.back();
+                    ptrs.pop_back();
+                }
+            }
+            handoff[t] = ptrs;
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    // Freed by the main thread, whatever shard they came from
+    for (const std::vector<void*>& ptrs : handoff) {
+        for (void* ptr : ptrs) {
+            allocator.Free(ptr);
+        }
+    }
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "SlabAllocator.h"
+#include <set>
+#include <vector>
+
+static_assert(SlabSizeClasses::SizeToClass(1) == 0, "");
+static_assert(SlabSizeClasses::SizeToClass(16) == 0, "");
+static_assert(SlabSizeClasses::SizeToClass(17) == 1, "");
+static_assert(SlabSizeClasses::ClassSize(SlabSizeClasses::SizeToClass(129)) == 160, "");
+static_assert(SlabSizeClasses::ClassSize(SlabSizeClasses::SizeToClass(257)) == 320, "");
+
+TEST(SlabAllocatorTests, SizeClassesBoundFragmentation) {
+    for (std::size_t size = 1; size <= SlabSizeClasses::MAX_SIZE; ++size) {
+        const std::size_t classSize = SlabSizeClasses::ClassSize(SlabSizeClasses::SizeToClass(size));
+        ASSERT_GE(classSize, size);
+        if (size > SlabSizeClasses::SMALL_LIMIT) {
+            ASSERT_LE(classSize - size, classSize / 4);
+        }
+    }
+}
+
+TEST(SlabAllocatorTests, AllocateAndFree) {
+    SlabAllocator allocator(1 << 20);
+    allocator.Init();
+
+    void* ptr1 = allocator.Allocate(24, 8);
+    ASSERT_NE(ptr1, nullptr);
+
+    void* ptr2 = allocator.Allocate(1000, 8);
+    ASSERT_NE(ptr2, nullptr);
+    ASSERT_EQ(allocator.GetUsed(), 32 + 1024);
+
+    allocator.Free(ptr1);
+    allocator.Free(ptr2);
+    ASSERT_EQ(allocator.GetUsed(), 0);
+}
+
+TEST(SlabAllocatorTests, ReusesFreedChunk) {
+    SlabAllocator allocator(1 << 20);
+    allocator.Init();
+
+    void* ptr1 = allocator.Allocate(48, 8);
+    void* ptr2 = allocator.Allocate(48, 8);
+    allocator.Free(ptr1);
+
+    void* ptr3 = allocator.Allocate(40, 8);
+    ASSERT_EQ(ptr1, ptr3);
+
+    allocator.Free(ptr2);
+    allocator.Free(ptr3);
+}
+
+TEST(SlabAllocatorTests, AllocateWithAlignment) {
+    SlabAllocator allocator(1 << 20);
+    allocator.Init();
+
+    for (std::size_t alignment = 8; alignment <= 4096; alignment *= 2) {
+        void* ptr = allocator.Allocate(40, alignment);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_EQ(reinterpret_cast<std::size_t>(ptr) % alignment, 0);
+    }
+}
+
+TEST(SlabAllocatorTests, SpansAreRecycledAcrossClasses) {
+    const std::size_t totalSize = 2 * SlabAllocator::SPAN_SIZE;
+    SlabAllocator allocator(totalSize);
+    allocator.Init();
+
+    std::vector<void*> ptrs;
+    for (std::size_t i = 0; i < totalSize / 4096; ++i) {
+        ptrs.push_back(allocator.Allocate(4096, 8));
+        ASSERT_NE(ptrs.back(), nullptr);
+    }
+    ASSERT_EQ(allocator.Allocate(16, 8), nullptr);
+
+    for (void* ptr : ptrs) {
+        allocator.Free(ptr);
+    }
+    ASSERT_NE(allocator.Allocate(16, 8), nullptr);
+}
+
+TEST(SlabAllocatorTests, Reset) {
+    SlabAllocator allocator(1 << 20);
+    allocator.Init();
+
+    std::set<void*> ptrs;
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(ptrs.insert(allocator.Allocate(64, 8)).second);
+    }
+
+    allocator.Reset();
+    ASSERT_EQ(allocator.GetUsed(), 0);
+    ASSERT_NE(allocator.Allocate(64, 8), nullptr);
+}
@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
-#include "StackAllocator.h"
+#include "StackAllocator.h"
+#include "ScopedArena.h"
+#include <sys/mman.h>
+#include <cstring>
+#include <vector>
 
 TEST(StackAllocatorTests, InitializesCorrectly)
 {
@@ -66,3 +70,137 @@ TEST(StackAllocatorTests, ResetClearsMemory)
     ASSERT_EQ(allocator.GetUsed(), 0);
     ASSERT_EQ(allocator.GetPeak(), 0);
 }
+
+namespace {
+std::size_t ResidentPages(void *ptr, const std::size_t size)
+{
+    const std::size_t pageSize = RegionProvider::GetPageSize();
+    std::vector<unsigned char> pages((size + pageSize - 1) / pageSize);
+    mincore(ptr, size, pages.data());
+    std::size_t resident = 0;
+    for (unsigned char page : pages) {
+        resident += page & 1;
+    }
+    return resident;
+}
+}
+
+TEST(StackAllocatorTests, ReserveModeDecommitsAboveRetainedSize)
+{
+    const std::size_t totalSize = 64 * 1024 * 1024;
+    const std::size_t retainedSize = 1024 * 1024;
+    StackAllocator allocator(totalSize);
+    allocator.SetRegionProvider(RegionProvider::Get(RegionProvider::MMAP));
+    allocator.SetReserveMode(retainedSize);
+    allocator.Init();
+
+    void *big = allocator.Allocate(32 * 1024 * 1024, 8);
+    ASSERT_NE(big, nullptr);
+    memset(big, 1, 32 * 1024 * 1024);
+    ASSERT_GE(ResidentPages(allocator.GetStartPtr(), totalSize) * RegionProvider::GetPageSize(), 32u * 1024 * 1024);
+
+    allocator.Reset();
+    ASSERT_LE(ResidentPages(allocator.GetStartPtr(), totalSize) * RegionProvider::GetPageSize(), retainedSize);
+
+    // Decommitted pages are committed again on demand
+    void *ptr = allocator.Allocate(8 * 1024 * 1024, 8);
+    ASSERT_NE(ptr, nullptr);
+    memset(ptr, 2, 8 * 1024 * 1024);
+    ASSERT_EQ(allocator.Allocate(totalSize, 8), nullptr);
+}
+
+TEST(StackAllocatorTests, FreeToMarkerReleasesEverythingAfterIt)
+{
+    StackAllocator allocator(4096);
+    allocator.Init();
+
+    void *outer = allocator.Allocate(100, 8);
+    ASSERT_NE(outer, nullptr);
+    const StackAllocator::Marker marker = allocator.GetMarker();
+    const std::size_t used = allocator.GetUsed();
+
+    void *first = allocator.AllocateHeaderless(24, 8);
+    ASSERT_NE(first, nullptr);
+    ASSERT_EQ(reinterpret_cast<std::size_t>(first) % 8, 0u);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_NE(allocator.AllocateHeaderless(24, 8), nullptr);
+    }
+    ASSERT_NE(allocator.Allocate(64, 16), nullptr);
+
+    allocator.FreeToMarker(marker);
+    ASSERT_EQ(allocator.GetUsed(), used);
+    ASSERT_EQ(allocator.AllocateHeaderless(24, 8), first);
+
+    // The allocation made before the marker is still freed the usual way
+    allocator.FreeToMarker(marker);
+    allocator.Free(outer);
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+}
+
+TEST(StackAllocatorTests, HeaderlessAllocationsArePacked)
+{
+    StackAllocator allocator(4096);
+    allocator.Init();
+
+    char *first = static_cast<char *>(allocator.AllocateHeaderless(16, 16));
+    char *second = static_cast<char *>(allocator.AllocateHeaderless(16, 16));
+    ASSERT_EQ(second - first, 16);
+}
+
+TEST(StackAllocatorTests, ScopedArenaRewindsOnExit)
+{
+    StackAllocator allocator(1 << 16);
+    allocator.Init();
+
+    void *first;
+    {
+        ScopedArena<StackAllocator> scope(allocator);
+        first = scope.Allocate(512, 16);
+        ASSERT_NE(first, nullptr);
+        {
+            ScopedArena<StackAllocator> nested(allocator);
+            for (int i = 0; i < 50; ++i) {
+                ASSERT_NE(nested.Allocate(512, 16), nullptr);
+            }
+        }
+        ASSERT_EQ(allocator.GetUsed(), static_cast<std::size_t>(static_cast<char *>(first) + 512 - static_cast<char *>(allocator.GetStartPtr())));
+    }
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+}
+
+TEST(StackAllocatorTests, ReallocateExtendsTopAllocation)
+{
+    StackAllocator allocator(1024);
+    allocator.Init();
+
+    char* bottom = static_cast<char*>(allocator.Allocate(16, 8));
+    char* top = static_cast<char*>(allocator.Allocate(16, 8));
+    memset(bottom, 1, 16);
+    memset(top, 2, 16);
+
+    ASSERT_EQ(allocator.Reallocate(top, 500, 8), top);
+    ASSERT_EQ(allocator.Reallocate(top, 2000, 8), nullptr);
+    // Still the top, popping it goes back under it
+    allocator.Free(top);
+    ASSERT_EQ(allocator.Allocate(16, 8), top);
+    allocator.Free(top);
+
+    char* moved = static_cast<char*>(allocator.Reallocate(bottom, 64, 8));
+    ASSERT_GT(moved, bottom);
+    for (int i = 0; i < 16; ++i) {
+        ASSERT_EQ(moved[i], 1);
+    }
+}
+
+TEST(StackAllocatorTests, FreeSizedPopsHeaderlessAllocations)
+{
+    StackAllocator allocator(1024);
+    allocator.Init();
+
+    void* first = allocator.AllocateHeaderless(24, 8);
+    void* second = allocator.AllocateHeaderless(24, 8);
+    allocator.FreeSized(second, 24);
+    ASSERT_EQ(allocator.GetUsed(), static_cast<std::size_t>(static_cast<char*>(second) - static_cast<char*>(allocator.GetStartPtr())));
+    allocator.FreeSized(first, 24);
+    ASSERT_EQ(allocator.AllocateHeaderless(24, 8), first);
+}
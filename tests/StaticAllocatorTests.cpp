@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "StaticAllocator.h"
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+static bool IsAligned(const void* ptr, const std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+TEST(StaticAllocatorTests, LinearBumpsAndResets) {
+    StaticAllocator<LinearStorage, 16> allocator(1024);
+    allocator.Init();
+
+    char* ptr1 = (char*) allocator.Allocate(10);
+    char* ptr2 = (char*) allocator.Allocate(10);
+    ASSERT_NE(ptr1, nullptr);
+    ASSERT_TRUE(IsAligned(ptr1, 16));
+    ASSERT_EQ(ptr2, ptr1 + 16);
+
+    ASSERT_EQ(allocator.Allocate(2048), nullptr);
+
+    allocator.Reset();
+    ASSERT_EQ(allocator.Allocate(10), ptr1);
+}
+
+TEST(StaticAllocatorTests, PoolRecyclesChunks) {
+    StaticAllocator<PoolStorage<48>, 64> allocator(64 * 4);
+    allocator.Init();
+
+    std::set<void*> chunks;
+    for (int i = 0; i < 4; ++i) {
+        void* ptr = allocator.Allocate(48);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_TRUE(IsAligned(ptr, 64));
+        chunks.insert(ptr);
+    }
+    ASSERT_EQ(chunks.size(), 4u);
+    ASSERT_EQ(allocator.Allocate(48), nullptr);
+
+    void* last = *chunks.begin();
+    allocator.Free(last, 48);
+    ASSERT_EQ(allocator.Allocate(48), last);
+}
+
+TEST(StaticAllocatorTests, FreeListPlacementPolicies) {
+    StaticAllocator<FreeListStorage<FreeListAllocator::FIND_FIRST>> firstFit(1 << 16);
+    StaticAllocator<FreeListStorage<FreeListAllocator::FIND_BEST>, 32> bestFit(1 << 16);
+    firstFit.Init();
+    bestFit.Init();
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 32; ++i) {
+        void* ptr = bestFit.Allocate(100);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_TRUE(IsAligned(ptr, 32));
+        ptrs.push_back(ptr);
+        ASSERT_NE(firstFit.Allocate(100), nullptr);
+    }
+    for (void* ptr : ptrs) {
+        bestFit.Free(ptr, 100);
+    }
+    // Everything coalesced back, the whole region fits again
+    ASSERT_NE(bestFit.Allocate(1 << 15), nullptr);
+    ASSERT_EQ(bestFit.Allocate(1 << 16), nullptr);
+}
+
+TEST(StaticAllocatorTests, TrackStatsCountsBytes) {
+    StaticAllocator<PoolStorage<64>, 8, NoLock, TrackStats> allocator(64 * 8);
+    allocator.Init();
+
+    void* ptr1 = allocator.Allocate(64);
+    void* ptr2 = allocator.Allocate(32);
+    ASSERT_EQ(allocator.GetUsed(), 96u);
+    allocator.Free(ptr1, 64);
+    ASSERT_EQ(allocator.GetUsed(), 32u);
+    ASSERT_EQ(allocator.GetPeak(), 96u);
+    allocator.Free(ptr2, 32);
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+
+    allocator.Reset();
+    ASSERT_EQ(allocator.GetPeak(), 0u);
+}
+
+TEST(StaticAllocatorTests, NoStatsReportsNothing) {
+    StaticAllocator<LinearStorage> allocator(1024);
+    allocator.Init();
+    ASSERT_NE(allocator.Allocate(100), nullptr);
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+    ASSERT_EQ(allocator.GetPeak(), 0u);
+}
+
+TEST(StaticAllocatorTests, MutexLockSharedBetweenThreads) {
+    const int nThreads = 4;
+    const int nChunks = 1000;
+    StaticAllocator<PoolStorage<64>, 8, MutexLock, TrackStats> allocator(64 * nThreads * nChunks);
+    allocator.Init();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&allocator]() {
+            std::vector<void*> ptrs;
+            for (int round = 0; round < 10; ++round) {
+                for (int i = 0; i < nChunks; ++i) {
+                    ptrs.push_back(allocator.Allocate(64));
+                }
+                for (void* ptr : ptrs) {
+                    allocator.Free(ptr, 64);
+                }
+                ptrs.clear();
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+    ASSERT_LE(allocator.GetPeak(), 64u * nThreads * nChunks);
+}
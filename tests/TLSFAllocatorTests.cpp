@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "TLSFAllocator.h"
+#include <cstring>
+#include <random>
+#include <vector>
+
+TEST(TLSFAllocatorTests, AllocateAndFree) {
+    TLSFAllocator allocator(1024);
+    allocator.Init();
+
+    void* ptr1 = allocator.Allocate(16, 8);
+    ASSERT_NE(ptr1, nullptr);
+
+    void* ptr2 = allocator.Allocate(32, 8);
+    ASSERT_NE(ptr2, nullptr);
+    ASSERT_NE(ptr1, ptr2);
+
+    allocator.Free(ptr1);
+    allocator.Free(ptr2);
+    ASSERT_EQ(allocator.GetUsed(), 0);
+}
+
+TEST(TLSFAllocatorTests, AlignmentPadding) {
+    TLSFAllocator allocator(1 << 16);
+    allocator.Init();
+
+    for (std::size_t alignment = 8; alignment <= 1024; alignment *= 2) {
+        void* ptr = allocator.Allocate(24, alignment);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_EQ(reinterpret_cast<std::size_t>(ptr) % alignment, 0);
+    }
+}
+
+TEST(TLSFAllocatorTests, Coalescence) {
+    TLSFAllocator allocator(1024);
+    allocator.Init();
+
+    void* ptr1 = allocator.Allocate(200, 8);
+    void* ptr2 = allocator.Allocate(200, 8);
+    void* ptr3 = allocator.Allocate(200, 8);
+    allocator.Free(ptr1);
+    allocator.Free(ptr3);
+    allocator.Free(ptr2);
+
+    void* ptr4 = allocator.Allocate(900, 8);
+    ASSERT_EQ(ptr4, ptr1);
+
+    allocator.Free(ptr4);
+}
+
+TEST(TLSFAllocatorTests, OutOfMemory) {
+    TLSFAllocator allocator(1024);
+    allocator.Init();
+
+    ASSERT_EQ(allocator.Allocate(2048, 8), nullptr);
+}
+
+TEST(TLSFAllocatorTests, RandomOperationsKeepDataIntact) {
+    TLSFAllocator allocator(1 << 24);
+    allocator.Init();
+
+    std::minstd_rand generator(1);
+    std::vector<std::pair<unsigned char*, std::size_t>> live;
+    for (int i = 0; i < 20000; ++i) {
+        if (live.empty() || generator() % 3 != 0) {
+            const std::size_t size = 1 + generator() % 2000;
+            unsigned char* ptr = static_cast<unsigned char*>(allocator.Allocate(size, 8 << (generator() % 4)));
+            ASSERT_NE(ptr, nullptr);
+            std::memset(ptr, (int) (size & 0xFF), size);
+            live.emplace_back(ptr, size);
+        } else {
+            const std::size_t index = generator() % live.size();
+            for (std::size_t b = 0; b < live[index].second; ++b) {
+                ASSERT_EQ(live[index].first[b], live[index].second & 0xFF);
+            }
+            allocator.Free(live[index].first);
+            live[index] = live.back();
+            live.pop_back();
+        }
+    }
+    for (auto& allocation : live) {
+        allocator.Free(allocation.first);
+    }
+    ASSERT_EQ(allocator.GetUsed(), 0);
+
+    // Everything coalesced back into one block
+    ASSERT_NE(allocator.Allocate(12 << 20, 8), nullptr);
+}
+
+TEST(TLSFAllocatorTests, Reset) {
+    TLSFAllocator allocator(1024);
+    allocator.Init();
+
+    allocator.Allocate(500, 8);
+    allocator.Reset();
+
+    ASSERT_NE(allocator.Allocate(900, 8), nullptr);
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include "ThreadCacheAllocator.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(ThreadCacheAllocatorTests, AllocateAndFree) {
+    ThreadCacheAllocator allocator(1 << 20);
+    allocator.Init();
+
+    void* ptr1 = allocator.Allocate(24, 8);
+    ASSERT_NE(ptr1, nullptr);
+
+    void* ptr2 = allocator.Allocate(24, 8);
+    ASSERT_NE(ptr2, nullptr);
+    ASSERT_NE(ptr1, ptr2);
+
+    allocator.Free(ptr1);
+    allocator.Free(ptr2);
+}
+
+TEST(ThreadCacheAllocatorTests, FreedChunkIsReusedFromCache) {
+    ThreadCacheAllocator allocator(1 << 20);
+    allocator.Init();
+
+    void* ptr1 = allocator.Allocate(100, 8);
+    allocator.Free(ptr1);
+
+    void* ptr2 = allocator.Allocate(128, 8);
+    ASSERT_EQ(ptr1, ptr2);
+
+    allocator.Free(ptr2);
+}
+
+TEST(ThreadCacheAllocatorTests, LargeAllocation) {
+    ThreadCacheAllocator allocator(1 << 20);
+    allocator.Init();
+
+    void* ptr = allocator.Allocate(10000, 64);
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ(reinterpret_cast<std::size_t>(ptr) % 64, 0);
+
+    allocator.Free(ptr);
+}
+
+TEST(ThreadCacheAllocatorTests, FreeNullptrIsIgnored) {
+    ThreadCacheAllocator allocator(1 << 20);
+    allocator.Init();
+
+    void* ptr = allocator.Allocate(10000, 8);
+    const std::size_t used = allocator.GetUsed();
+    allocator.Free(nullptr);
+    ASSERT_EQ(allocator.GetUsed(), used);
+
+    allocator.Free(ptr);
+    ASSERT_EQ(allocator.GetUsed(), 0u);
+}
+
+TEST(ThreadCacheAllocatorTests, FlushReturnsChunks) {
+    ThreadCacheAllocator allocator(1 << 20);
+    allocator.Init();
+
+    void* ptr = allocator.Allocate(64, 8);
+    ASSERT_EQ(allocator.GetUsed(), ThreadCacheAllocator::BATCH_SIZE * 64);
+
+    allocator.Free(ptr);
+    allocator.Flush();
+    ASSERT_EQ(allocator.GetUsed(), 0);
+}
+
+TEST(ThreadCacheAllocatorTests, ConcurrentAllocateAndFree) {
+    ThreadCacheAllocator allocator(1 << 24);
+    allocator.Init();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&allocator]() {
+            std::vector<void*> ptrs;
+            for (int round = 0; round < 10; ++round) {
+                for (int i = 0; i < 200; ++i) {
+                    void* ptr = allocator.Allocate(16 << (i % 6), 8);
+                    ASSERT_NE(ptr, nullptr);
+                    ptrs.push_back(ptr);
+                }
+                for (void* ptr : ptrs) {
+                    allocator.Free(ptr);
+                }
+                ptrs.clear();
+            }
+            allocator.Flush();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(allocator.GetUsed(), 0);
+}
+
+TEST(ThreadCacheAllocatorTests, MoreThreadsThanCaches) {
+    ThreadCacheAllocator allocator(1 << 24, 2);
+    allocator.Init();
+
+    // Every thread keeps its blocks until all of them allocated, so they are alive at the same time and most of
+    // them get an index past the caches
+    const int nThreads = 8;
+    std::atomic<int> allocated{0};
+    std::atomic<bool> release{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&allocator, &allocated, &release]() {
+            std::vector<void*> ptrs;
+            for (int i = 0; i < 200; ++i) {
+                void* ptr = allocator.Allocate(16 << (i % 6), 8);
+                ASSERT_NE(ptr, nullptr);
+                ptrs.push_back(ptr);
+            }
+            ++allocated;
+            while (!release) {
+                std::this_thread::yield();
+            }
+            for (void* ptr : ptrs) {
+                allocator.Free(ptr);
+            }
+            allocator.Flush();
+        });
+    }
+    while (allocated < nThreads) {
+        std::this_thread::yield();
+    }
+    release = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(allocator.GetUsed(), 0);
+}